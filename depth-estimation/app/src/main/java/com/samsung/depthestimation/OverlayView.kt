@@ -5,7 +5,6 @@ package com.samsung.depthestimation
 import android.content.Context
 import android.graphics.Bitmap
 import android.graphics.Canvas
-import android.graphics.Color
 import android.util.AttributeSet
 import android.view.View
 import java.lang.Float.min
@@ -16,18 +15,8 @@ class OverlayView(
 ) : View(context, attrs) {
     private var resultMask: Bitmap? = null
 
-    fun setResults(alphaArray: IntArray, imageWidth: Int, imageHeight: Int) {
-        val pixels = IntArray(alphaArray.size)
-
-        alphaArray.forEachIndexed { index, value ->
-            pixels[index] = Color.argb(220, 255 - value, value, 255)
-        }
-
-        val image = Bitmap.createBitmap(
-            pixels, imageWidth, imageHeight, Bitmap.Config.ARGB_8888
-        )
-
-        resultMask = createScaledBitmap(image, imageWidth, imageHeight)
+    fun setResults(depthMap: Bitmap) {
+        resultMask = createScaledBitmap(depthMap, depthMap.width, depthMap.height)
     }
 
     override fun onDraw(canvas: Canvas) {
@@ -0,0 +1,8 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+package com.samsung.depthestimation.data
+
+enum class DepthColormap {
+    OVERLAY,    // Translucent magenta to cyan, far to near
+    GRAYSCALE,  // Opaque black to white, far to near
+}
\ No newline at end of file
@@ -22,4 +22,9 @@ object ModelConstants {
 
     const val OUTPUT_CONVERSION_SCALE = 1F
     const val OUTPUT_CONVERSION_OFFSET = 0F
+
+    val DEPTH_COLORMAP = DepthColormap.OVERLAY
+
+    // Weight of the newest frame in the smoothed camera depth range, 0 disables smoothing
+    const val DEPTH_RANGE_EMA_ALPHA = 0.2F
 }
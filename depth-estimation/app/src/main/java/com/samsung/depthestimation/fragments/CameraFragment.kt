@@ -3,7 +3,6 @@
 package com.samsung.depthestimation.fragments
 
 import android.graphics.Bitmap
-import android.graphics.Matrix
 import android.os.Bundle
 import android.util.Log
 import android.view.LayoutInflater
@@ -19,7 +18,6 @@ import androidx.camera.lifecycle.ProcessCameraProvider
 import androidx.camera.view.PreviewView
 import androidx.core.content.ContextCompat
 import androidx.fragment.app.Fragment
-import com.samsung.depthestimation.data.ModelConstants
 import com.samsung.depthestimation.databinding.FragmentCameraBinding
 import com.samsung.depthestimation.executor.ModelExecutor
 import java.util.concurrent.ExecutorService
@@ -30,7 +28,6 @@ class CameraFragment : Fragment(), ModelExecutor.ExecutorListener {
     private lateinit var binding: FragmentCameraBinding
     private lateinit var modelExecutor: ModelExecutor
     private lateinit var cameraExecutor: ExecutorService
-    private lateinit var bitmapBuffer: Bitmap
 
     private var camera: Camera? = null
     private var preview: Preview? = null
@@ -104,12 +101,6 @@ class CameraFragment : Fragment(), ModelExecutor.ExecutorListener {
             .setOutputImageFormat(ImageAnalysis.OUTPUT_IMAGE_FORMAT_RGBA_8888) // Set the output image format to RGBA_8888
             .build().also {
                 it.setAnalyzer(cameraExecutor) { image -> // Set the analyzer to run on the previously created executor
-                    if (!::bitmapBuffer.isInitialized) { // If the bitmapBuffer is not initialized
-                        // Create a new bitmap with the same dimensions as the image
-                        bitmapBuffer = Bitmap.createBitmap(
-                            image.width, image.height, Bitmap.Config.ARGB_8888
-                        )
-                    }
                     // Process the image
                     process(image)
                 }
@@ -118,39 +109,14 @@ class CameraFragment : Fragment(), ModelExecutor.ExecutorListener {
 
     // Process the image
     private fun process(image: ImageProxy) {
-        image.use { bitmapBuffer.copyPixelsFromBuffer(image.planes[0].buffer) }
-        modelExecutor.process(processImage(bitmapBuffer))
-    }
-
-    private fun processImage(bitmap: Bitmap): Bitmap {
-        val rotationMatrix = Matrix().apply { postRotate(90F) }
-        val rotatedBitmap = Bitmap.createBitmap(
-            bitmap, 0, 0, bitmap.width, bitmap.height, rotationMatrix, true
-        )
-        val (scaledWidth, scaledHeight) = calculateScaleSize(
-            rotatedBitmap.width, rotatedBitmap.height
-        )
-        val scaledBitmap = Bitmap.createScaledBitmap(
-            rotatedBitmap, scaledWidth, scaledHeight, true
-        )
-        val (x, y) = calculateCenterCropPosition(scaledBitmap)
-
-        return Bitmap.createBitmap(scaledBitmap, x, y, INPUT_SIZE_W, INPUT_SIZE_H)
-    }
-
-    private fun calculateScaleSize(bitmapWidth: Int, bitmapHeight: Int): Pair<Int, Int> {
-        val scaleFactor = maxOf(
-            INPUT_SIZE_W.toDouble() / bitmapWidth, INPUT_SIZE_H.toDouble() / bitmapHeight
-        )
-
-        return Pair((bitmapWidth * scaleFactor).toInt(), (bitmapHeight * scaleFactor).toInt())
-    }
-
-    private fun calculateCenterCropPosition(scaledBitmap: Bitmap): Pair<Int, Int> {
-        return Pair(
-            (scaledBitmap.width - INPUT_SIZE_W) / 2,
-            (scaledBitmap.height - INPUT_SIZE_H) / 2
-        )
+        // The RGBA_8888 plane is rotated, scaled, center cropped and converted into the input
+        // buffer natively, and is only valid until the image is closed
+        image.use {
+            val plane = image.planes[0]
+            modelExecutor.processStream(
+                plane.buffer, image.width, image.height, plane.rowStride, FRAME_ROTATION
+            )
+        }
     }
 
     private fun setUI() {
@@ -163,27 +129,26 @@ class CameraFragment : Fragment(), ModelExecutor.ExecutorListener {
 
     // Handle results
     override fun onResults(
-        result: IntArray, inferenceTime: Long
+        result: Bitmap, inferenceTime: Long
     ) {
         activity?.runOnUiThread {
             binding.processData.inferenceTime.text = "$inferenceTime ms"
-            binding.overlay.setResults(
-                result, OUTPUT_SIZE_W, OUTPUT_SIZE_H
-            )
+            binding.overlay.setResults(result)
             binding.overlay.invalidate()
         }
     }
 
     override fun onDestroy() {
         super.onDestroy()
-        modelExecutor.closeENN()
+        // Closed on the analyzer thread once the frame it may be processing is done, so that
+        // the buffers are not released under it. No frame is analyzed after the shutdown.
+        cameraExecutor.execute { modelExecutor.closeENN() }
+        cameraExecutor.shutdown()
     }
 
     companion object {
         private const val TAG = "CameraFragment"
-        private const val INPUT_SIZE_W = ModelConstants.INPUT_SIZE_W
-        private const val INPUT_SIZE_H = ModelConstants.INPUT_SIZE_H
-        private const val OUTPUT_SIZE_W = ModelConstants.OUTPUT_SIZE_W
-        private const val OUTPUT_SIZE_H = ModelConstants.OUTPUT_SIZE_H
+        // Rotation of the back camera frames to the portrait model input
+        private const val FRAME_ROTATION = 90
     }
 }
\ No newline at end of file
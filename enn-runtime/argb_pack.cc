@@ -0,0 +1,86 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "argb_pack.h"
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+inline uint8_t saturate(float value, float scale, float offset) {
+    // Rounded after the multiply and after the add, like the Kotlin and NEON paths;
+    // CMakeLists.txt builds this file with -ffp-contract=off so that no FMA fuses them
+    float scaled = value * scale;
+    scaled += offset;
+
+    if (!(scaled > 0.0f)) {
+        return 0;
+    }
+    return scaled >= 255.0f ? 255 : static_cast<uint8_t>(scaled);
+}
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+// Saturating narrows clamp the truncated values to 0..255
+inline uint8x8_t saturate_x8(float32x4_t low, float32x4_t high, float32x4_t scale,
+                             float32x4_t offset) {
+    const int32x4_t low_value = vcvtq_s32_f32(vaddq_f32(vmulq_f32(low, scale), offset));
+    const int32x4_t high_value = vcvtq_s32_f32(vaddq_f32(vmulq_f32(high, scale), offset));
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(low_value), vqmovn_s32(high_value)));
+}
+
+#endif
+
+}  // namespace
+
+void pack_float_to_rgba(const float *src, uint32_t width, uint32_t height, PreprocessLayer layer,
+                        float scale, float offset, uint8_t *dst, uint32_t dst_stride) {
+    const uint32_t plane = width * height;
+    const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+    const uint32_t channel_offset = layer == PREPROCESS_LAYER_HWC ? 1 : plane;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t scale_vector = vdupq_n_f32(scale);
+    const float32x4_t offset_vector = vdupq_n_f32(offset);
+#endif
+
+    for (uint32_t y = 0; y < height; y++) {
+        const float *row = src + static_cast<uint64_t>(y) * width * pixel_stride;
+        uint8_t *out = dst + static_cast<uint64_t>(y) * dst_stride;
+        uint32_t x = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+        for (; x + 8 <= width; x += 8) {
+            uint8x8x4_t rgba;
+
+            if (layer == PREPROCESS_LAYER_HWC) {
+                const float32x4x3_t low = vld3q_f32(row + x * 3);
+                const float32x4x3_t high = vld3q_f32(row + (x + 4) * 3);
+                for (int c = 0; c < 3; c++) {
+                    rgba.val[c] = saturate_x8(low.val[c], high.val[c], scale_vector,
+                                              offset_vector);
+                }
+            } else {
+                for (int c = 0; c < 3; c++) {
+                    const float *channel = row + c * plane + x;
+                    rgba.val[c] = saturate_x8(vld1q_f32(channel), vld1q_f32(channel + 4),
+                                              scale_vector, offset_vector);
+                }
+            }
+            rgba.val[3] = vdup_n_u8(255);
+            vst4_u8(out + x * 4, rgba);
+        }
+#endif
+
+        for (; x < width; x++) {
+            const float *channel = row + x * pixel_stride;
+            uint8_t *pixel = out + x * 4;
+
+            pixel[0] = saturate(channel[0], scale, offset);
+            pixel[1] = saturate(channel[channel_offset], scale, offset);
+            pixel[2] = saturate(channel[2 * channel_offset], scale, offset);
+            pixel[3] = 255;
+        }
+    }
+}
@@ -0,0 +1,25 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "preprocess.h"
+
+/**
+ * @brief Converts float RGB to opaque RGBA8888 pixels.
+ *
+ * Each channel is written as int(value * scale + offset) saturated to
+ * 0..255. Alpha is set to 255.
+ *
+ * @param src Pointer to width * height * 3 floats.
+ * @param width Number of pixels per row.
+ * @param height Number of rows.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param scale Value each channel is multiplied by.
+ * @param offset Value added to each channel.
+ * @param dst Pointer to the first row of the bitmap.
+ * @param dst_stride Distance between rows of dst in bytes.
+ */
+void pack_float_to_rgba(const float *src, uint32_t width, uint32_t height, PreprocessLayer layer,
+                        float scale, float offset, uint8_t *dst, uint32_t dst_stride);
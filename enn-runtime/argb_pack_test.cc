@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks pack_float_to_rgba against a scalar reference of the Kotlin convertToArgb it
+// replaced, with the channels clamped to 0..255. Rows of 8 pixels or more take the
+// NEON path on arm64, so the sizes cover empty images, tails that are not a multiple
+// of the blocks, single rows and the 600x400 output of image-enhance.
+//
+//   argb_pack_test
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "argb_pack.h"
+#include "test_helpers.h"
+
+namespace {
+
+// Value of the bytes after each row, which must not be written
+constexpr uint8_t kCanary = 0xA5;
+constexpr uint32_t kRowPadding = 12;
+
+struct Size {
+    uint32_t width;
+    uint32_t height;
+};
+
+const Size SIZES[] = {
+        {0, 0}, {0, 4}, {4, 0},
+        {1, 1}, {7, 1}, {8, 1}, {9, 1}, {15, 1}, {16, 1}, {17, 1}, {31, 1}, {33, 1}, {600, 1},
+        {1, 5}, {9, 3}, {17, 2}, {23, 7},
+        {600, 400},
+};
+
+struct Conversion {
+    float scale;
+    float offset;
+};
+
+// image-enhance, a [-1, 1] output, and an offset only
+const Conversion CONVERSIONS[] = {{256.0f, 0.0f}, {127.5f, 127.5f}, {1.0f, 0.5f}};
+
+// Channel values around the clamping edges and outside the model range, repeated
+// over the image
+const float VALUES[] = {
+        0.0f, 1.0f, 0.5f, -0.5f, 0.996f, 0.99609375f, 1.5f, -1.0f, 255.0f, 254.99f, -0.001f,
+        0.25f, 3e9f, -3e9f, std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(),
+};
+
+// (value * scale + offset).toInt() of Kotlin, clamped to a channel
+uint8_t reference_channel(float value, float scale, float offset) {
+    // volatile keeps the compiler from fusing the multiply and add into an FMA
+    volatile float scaled = value * scale;
+    const float converted = scaled + offset;
+
+    if (std::isnan(converted) || converted <= 0.0f) {
+        return 0;
+    }
+    if (converted >= 255.0f) {
+        return 255;
+    }
+    return static_cast<uint8_t>(static_cast<int32_t>(converted));
+}
+
+void check_pack(const Size &size, PreprocessLayer layer, const Conversion &conversion) {
+    const uint32_t plane = size.width * size.height;
+    const uint32_t stride = size.width * 4 + kRowPadding;
+    const uint32_t value_count = sizeof(VALUES) / sizeof(VALUES[0]);
+
+    std::vector<float> src(plane * 3);
+    for (uint32_t i = 0; i < src.size(); i++) {
+        // Spread so that the channels of a pixel and neighboring pixels differ
+        src[i] = VALUES[(i * 7 + i / 3) % value_count];
+    }
+
+    std::vector<uint8_t> expected(stride * size.height, kCanary);
+    for (uint32_t y = 0; y < size.height; y++) {
+        for (uint32_t x = 0; x < size.width; x++) {
+            const uint32_t pixel = y * size.width + x;
+            uint8_t *out = &expected[y * stride + x * 4];
+
+            for (uint32_t c = 0; c < 3; c++) {
+                const float value = layer == PREPROCESS_LAYER_HWC ? src[pixel * 3 + c]
+                                                                  : src[c * plane + pixel];
+                out[c] = reference_channel(value, conversion.scale, conversion.offset);
+            }
+            out[3] = 255;
+        }
+    }
+
+    std::vector<uint8_t> output(stride * size.height, kCanary);
+    pack_float_to_rgba(src.data(), size.width, size.height, layer, conversion.scale,
+                       conversion.offset, output.data(), stride);
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < output.size(); i++) {
+        mismatches += output[i] != expected[i];
+    }
+    EXPECT_TRUE(mismatches == 0, "%ux%u, layer %d, scale %g, offset %g: %u bytes differ",
+                size.width, size.height, layer, conversion.scale, conversion.offset,
+                mismatches);
+}
+
+}  // namespace
+
+int main() {
+    for (const Size &size : SIZES) {
+        for (PreprocessLayer layer : {PREPROCESS_LAYER_HWC, PREPROCESS_LAYER_CHW}) {
+            for (const Conversion &conversion : CONVERSIONS) {
+                check_pack(size, layer, conversion);
+            }
+        }
+    }
+
+    // A null image of zero pixels is never dereferenced
+    pack_float_to_rgba(nullptr, 0, 0, PREPROCESS_LAYER_HWC, 256.0f, 0.0f, nullptr, 0);
+
+    return TestResult("argb_pack_test");
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "camera_frame.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Output tile resampled into a stack buffer before conversion. 16 rows of 64
+// pixels keep the source rows of a 90 degree rotation, which advance along
+// output columns, in the L1 cache.
+constexpr uint32_t TILE_W = 64;
+constexpr uint32_t TILE_H = 16;
+
+// Bilinear taps along one output axis, as byte offsets into the frame
+struct Taps {
+    uint32_t offset0;
+    uint32_t offset1;
+    uint32_t weight;  // of offset1, 0 to 256
+};
+
+// Samples of an axis of the rotated frame that survive scaling to scaled_size and
+// cropping to size. Rotated index i of the axis starts at byte origin + i * step.
+std::vector<Taps> axis_taps(uint32_t rotated_size, uint32_t scaled_size, uint32_t size,
+                            int64_t origin, int64_t step) {
+    std::vector<Taps> taps(size);
+    const uint32_t crop = (scaled_size - size) / 2;
+    const float ratio = static_cast<float>(rotated_size) / scaled_size;
+
+    for (uint32_t i = 0; i < size; i++) {
+        // Pixel centers of the scaled frame mapped back to the rotated one
+        float position = (i + crop + 0.5f) * ratio - 0.5f;
+        position = std::min(std::max(position, 0.0f), static_cast<float>(rotated_size - 1));
+
+        const uint32_t index = static_cast<uint32_t>(position);
+        const uint32_t next = std::min(index + 1, rotated_size - 1);
+
+        taps[i].offset0 = static_cast<uint32_t>(origin + index * step);
+        taps[i].offset1 = static_cast<uint32_t>(origin + next * step);
+        taps[i].weight = static_cast<uint32_t>(std::lround((position - index) * 256));
+    }
+
+    return taps;
+}
+
+template <typename T, typename ConvertRow>
+void convert_frame(const uint8_t *src, uint32_t src_stride, uint32_t src_width,
+                   uint32_t src_height, uint32_t rotation, uint32_t width, uint32_t height,
+                   PreprocessLayer layer, T *dst, ConvertRow convert_row) {
+    const bool transposed = rotation == 90 || rotation == 270;
+    const uint32_t rotated_w = transposed ? src_height : src_width;
+    const uint32_t rotated_h = transposed ? src_width : src_height;
+
+    // Same rounding as calculateScaleSize of the camera fragments
+    const float scale_factor = std::max(static_cast<float>(width) / rotated_w,
+                                        static_cast<float>(height) / rotated_h);
+    const uint32_t scaled_w = std::max(static_cast<uint32_t>(rotated_w * scale_factor), width);
+    const uint32_t scaled_h = std::max(static_cast<uint32_t>(rotated_h * scale_factor), height);
+
+    // Byte position of rotated pixel (u, v) is the sum of a term of u and a term of v,
+    // so the inner loop is the same for every rotation
+    const int64_t pixel = 4;
+    const int64_t row = src_stride;
+    int64_t u_origin, u_step, v_origin, v_step;
+    switch (rotation) {
+        case 90:
+            u_origin = (src_height - 1) * row, u_step = -row;
+            v_origin = 0, v_step = pixel;
+            break;
+        case 180:
+            u_origin = (src_width - 1) * pixel, u_step = -pixel;
+            v_origin = (src_height - 1) * row, v_step = -row;
+            break;
+        case 270:
+            u_origin = 0, u_step = row;
+            v_origin = (src_width - 1) * pixel, v_step = -pixel;
+            break;
+        default:
+            u_origin = 0, u_step = pixel;
+            v_origin = 0, v_step = row;
+            break;
+    }
+
+    const std::vector<Taps> columns = axis_taps(rotated_w, scaled_w, width, u_origin, u_step);
+    const std::vector<Taps> rows = axis_taps(rotated_h, scaled_h, height, v_origin, v_step);
+
+    const uint32_t plane = width * height;
+    const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+    uint8_t tile[TILE_H][TILE_W * 4];
+
+    for (uint32_t y0 = 0; y0 < height; y0 += TILE_H) {
+        const uint32_t tile_h = std::min(TILE_H, height - y0);
+
+        for (uint32_t x0 = 0; x0 < width; x0 += TILE_W) {
+            const uint32_t tile_w = std::min(TILE_W, width - x0);
+
+            for (uint32_t y = 0; y < tile_h; y++) {
+                const Taps &v = rows[y0 + y];
+
+                for (uint32_t x = 0; x < tile_w; x++) {
+                    const Taps &u = columns[x0 + x];
+
+                    bilinear_rgba(src + u.offset0 + v.offset0, src + u.offset1 + v.offset0,
+                                  src + u.offset0 + v.offset1, src + u.offset1 + v.offset1,
+                                  u.weight, v.weight, tile[y] + x * 4);
+                }
+            }
+
+            for (uint32_t y = 0; y < tile_h; y++) {
+                convert_row(tile[y], tile_w, dst + ((y0 + y) * width + x0) * pixel_stride, plane);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void convert_frame_to_float(const uint8_t *src, uint32_t src_stride, uint32_t src_width,
+                            uint32_t src_height, uint32_t rotation, uint32_t width,
+                            uint32_t height, PreprocessLayer layer, float offset, float scale,
+                            float *dst) {
+    convert_frame(src, src_stride, src_width, src_height, rotation, width, height, layer, dst,
+                  [=](const uint8_t *tile_row, uint32_t count, float *out, uint32_t plane) {
+                      convert_rgba_row_to_float(tile_row, count, layer, offset, scale, out,
+                                                plane);
+                  });
+}
+
+void convert_frame_to_uint8(const uint8_t *src, uint32_t src_stride, uint32_t src_width,
+                            uint32_t src_height, uint32_t rotation, uint32_t width,
+                            uint32_t height, PreprocessLayer layer, float offset, float scale,
+                            uint8_t *dst) {
+    convert_frame(src, src_stride, src_width, src_height, rotation, width, height, layer, dst,
+                  [=](const uint8_t *tile_row, uint32_t count, uint8_t *out, uint32_t plane) {
+                      convert_rgba_row_to_uint8(tile_row, count, layer, offset, scale, out,
+                                                plane);
+                  });
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include "preprocess.h"
+
+/**
+ * @brief Converts a camera frame to normalized float32 RGB model input.
+ *
+ * The RGBA8888 frame is rotated clockwise, scaled with bilinear filtering
+ * until it covers width x height, and center cropped, like the
+ * Bitmap.createBitmap(matrix), createScaledBitmap and createBitmap chain of
+ * the camera fragments. Cropped pixels are never sampled. Each pixel is then
+ * converted like convert_rgba_to_float. The output is produced in small
+ * tiles, so no intermediate frame is allocated.
+ *
+ * @param src Pointer to the first pixel of the frame (R, G, B, A bytes per pixel).
+ * @param src_stride Distance between rows of src in bytes.
+ * @param src_width Number of pixels per row of the frame.
+ * @param src_height Number of rows of the frame.
+ * @param rotation Clockwise rotation in degrees: 0, 90, 180 or 270.
+ * @param width Number of pixels per row of the model input.
+ * @param height Number of rows of the model input.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param offset Value subtracted from each channel.
+ * @param scale Value each channel is divided by.
+ * @param dst Destination of width * height * 3 floats.
+ */
+void convert_frame_to_float(const uint8_t *src, uint32_t src_stride, uint32_t src_width,
+                            uint32_t src_height, uint32_t rotation, uint32_t width,
+                            uint32_t height, PreprocessLayer layer, float offset, float scale,
+                            float *dst);
+
+
+/**
+ * @brief Converts a camera frame to quantized uint8 RGB model input.
+ *
+ * Same geometry as convert_frame_to_float, with each pixel converted like
+ * convert_rgba_to_uint8.
+ *
+ * @param src Pointer to the first pixel of the frame (R, G, B, A bytes per pixel).
+ * @param src_stride Distance between rows of src in bytes.
+ * @param src_width Number of pixels per row of the frame.
+ * @param src_height Number of rows of the frame.
+ * @param rotation Clockwise rotation in degrees: 0, 90, 180 or 270.
+ * @param width Number of pixels per row of the model input.
+ * @param height Number of rows of the model input.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param offset Value subtracted from each channel.
+ * @param scale Value each channel is divided by.
+ * @param dst Destination of width * height * 3 bytes.
+ */
+void convert_frame_to_uint8(const uint8_t *src, uint32_t src_stride, uint32_t src_width,
+                            uint32_t src_height, uint32_t rotation, uint32_t width,
+                            uint32_t height, PreprocessLayer layer, float offset, float scale,
+                            uint8_t *dst);
+
+
+/**
+ * @brief Samples an RGBA8888 image at one position with bilinear filtering.
+ *
+ * Weights are quantized to 1/256 and the result is rounded, the arithmetic
+ * convert_frame_to_float and convert_frame_to_uint8 use for every pixel.
+ *
+ * @param p00 Top left neighbor.
+ * @param p10 Top right neighbor.
+ * @param p01 Bottom left neighbor.
+ * @param p11 Bottom right neighbor.
+ * @param wx Weight of the right neighbors, 0 to 256.
+ * @param wy Weight of the bottom neighbors, 0 to 256.
+ * @param dst Destination of the 4 channels.
+ */
+inline void bilinear_rgba(const uint8_t *p00, const uint8_t *p10, const uint8_t *p01,
+                          const uint8_t *p11, uint32_t wx, uint32_t wy, uint8_t *dst) {
+    for (int c = 0; c < 4; c++) {
+        const uint32_t top = (256 - wx) * p00[c] + wx * p10[c];
+        const uint32_t bottom = (256 - wx) * p01[c] + wx * p11[c];
+
+        dst[c] = static_cast<uint8_t>(((256 - wy) * top + wy * bottom + 32768) >> 16);
+    }
+}
@@ -0,0 +1,285 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Compares convert_frame_to_float / convert_frame_to_uint8 with the chain the
+// camera fragments ran before: copyPixelsFromBuffer into a frame bitmap, a
+// rotated copy, a scaled copy, a cropped copy and convert_rgba_to_*. The chain
+// allocates its bitmaps on every frame, like Bitmap.createBitmap does. Frames
+// are generated from a fixed seed, so that runs of the same build on the same
+// machine can be compared.
+//
+//   enn_runtime_benchmark [--repeat N] [--warmup N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "camera_frame.h"
+#include "preprocess.h"
+
+namespace {
+
+// Model inputs of the sample apps that run on camera frames
+struct ModelInput {
+    const char *app;
+    uint32_t width;
+    uint32_t height;
+    bool quantized;
+    float offset;
+    float scale;
+};
+
+const ModelInput MODEL_INPUTS[] = {
+        {"image-classification", 299, 299, true, 0.0f, 1.0f},
+        {"depth-estimation", 256, 256, false, 127.5f, 127.5f},
+        {"segmentation", 257, 257, false, 127.5f, 127.5f},
+        {"object-detection", 640, 640, false, 127.5f, 127.5f},
+};
+
+// Analysis resolutions CameraX hands to the fragments
+struct FrameSize {
+    uint32_t width;
+    uint32_t height;
+};
+
+const FrameSize FRAME_SIZES[] = {{640, 480}, {1280, 720}, {1920, 1080}};
+
+// The fragments rotate every frame by 90 degrees
+constexpr uint32_t ROTATION = 90;
+
+// Row padding of the RGBA plane, as some camera HALs add
+constexpr uint32_t ROW_PADDING = 64;
+
+struct Frame {
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    std::vector<uint8_t> pixels;
+};
+
+// Smooth gradients with sensor-like noise, so that neighboring pixels differ
+// the way they do in camera frames
+Frame make_frame(uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> noise(0.0f, 6.0f);
+    Frame frame = {width, height, width * 4 + ROW_PADDING, {}};
+    frame.pixels.resize(static_cast<size_t>(frame.stride) * height);
+
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t *row = frame.pixels.data() + static_cast<size_t>(y) * frame.stride;
+
+        for (uint32_t x = 0; x < width; x++) {
+            const float base[3] = {
+                    255.0f * x / width,
+                    255.0f * y / height,
+                    127.5f + 127.5f * std::sin(0.02f * (x + y)),
+            };
+            for (int c = 0; c < 3; c++) {
+                const float value = base[c] + noise(generator);
+                row[x * 4 + c] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f));
+            }
+            row[x * 4 + 3] = 255;
+        }
+    }
+
+    return frame;
+}
+
+// Bitmap.createBitmap(bitmap, 0, 0, w, h, postRotate(90), true)
+std::vector<uint8_t> rotate_90(const std::vector<uint8_t> &src, uint32_t width, uint32_t height) {
+    std::vector<uint8_t> dst(src.size());
+
+    for (uint32_t y = 0; y < width; y++) {
+        for (uint32_t x = 0; x < height; x++) {
+            memcpy(&dst[(static_cast<size_t>(y) * height + x) * 4],
+                   &src[(static_cast<size_t>(height - 1 - x) * width + y) * 4], 4);
+        }
+    }
+
+    return dst;
+}
+
+// Pixel centers of the scaled image mapped back to the source, with the
+// weights convert_frame_to_* uses
+void scale_taps(uint32_t src_size, uint32_t dst_size, std::vector<uint32_t> *index,
+                std::vector<uint32_t> *next, std::vector<uint32_t> *weight) {
+    const float ratio = static_cast<float>(src_size) / dst_size;
+
+    for (uint32_t i = 0; i < dst_size; i++) {
+        float position = (i + 0.5f) * ratio - 0.5f;
+        position = std::min(std::max(position, 0.0f), static_cast<float>(src_size - 1));
+
+        index->push_back(static_cast<uint32_t>(position));
+        next->push_back(std::min(index->back() + 1, src_size - 1));
+        weight->push_back(static_cast<uint32_t>(std::lround((position - index->back()) * 256)));
+    }
+}
+
+// Bitmap.createScaledBitmap(bitmap, dst_width, dst_height, true)
+std::vector<uint8_t> scale(const std::vector<uint8_t> &src, uint32_t width, uint32_t height,
+                           uint32_t dst_width, uint32_t dst_height) {
+    std::vector<uint32_t> x0, x1, wx, y0, y1, wy;
+    scale_taps(width, dst_width, &x0, &x1, &wx);
+    scale_taps(height, dst_height, &y0, &y1, &wy);
+
+    std::vector<uint8_t> dst(static_cast<size_t>(dst_width) * dst_height * 4);
+    for (uint32_t y = 0; y < dst_height; y++) {
+        const uint8_t *top = &src[static_cast<size_t>(y0[y]) * width * 4];
+        const uint8_t *bottom = &src[static_cast<size_t>(y1[y]) * width * 4];
+
+        for (uint32_t x = 0; x < dst_width; x++) {
+            bilinear_rgba(top + x0[x] * 4, top + x1[x] * 4, bottom + x0[x] * 4,
+                          bottom + x1[x] * 4, wx[x], wy[y],
+                          &dst[(static_cast<size_t>(y) * dst_width + x) * 4]);
+        }
+    }
+
+    return dst;
+}
+
+// Bitmap.createBitmap(bitmap, x, y, width, height)
+std::vector<uint8_t> crop(const std::vector<uint8_t> &src, uint32_t src_width, uint32_t x,
+                          uint32_t y, uint32_t width, uint32_t height) {
+    std::vector<uint8_t> dst(static_cast<size_t>(width) * height * 4);
+
+    for (uint32_t row = 0; row < height; row++) {
+        memcpy(&dst[static_cast<size_t>(row) * width * 4],
+               &src[(static_cast<size_t>(y + row) * src_width + x) * 4], width * 4);
+    }
+
+    return dst;
+}
+
+// CameraFragment.process and processImage followed by ModelExecutor.preProcess
+template <typename T>
+void run_chain(const Frame &frame, std::vector<uint8_t> *bitmap_buffer, const ModelInput &input,
+               T *dst) {
+    // copyPixelsFromBuffer, which drops the row padding
+    for (uint32_t y = 0; y < frame.height; y++) {
+        memcpy(bitmap_buffer->data() + static_cast<size_t>(y) * frame.width * 4,
+               frame.pixels.data() + static_cast<size_t>(y) * frame.stride, frame.width * 4);
+    }
+
+    const std::vector<uint8_t> rotated = rotate_90(*bitmap_buffer, frame.width, frame.height);
+    const uint32_t rotated_w = frame.height;
+    const uint32_t rotated_h = frame.width;
+
+    // calculateScaleSize and calculateCenterCropPosition
+    const float scale_factor = std::max(static_cast<float>(input.width) / rotated_w,
+                                        static_cast<float>(input.height) / rotated_h);
+    const uint32_t scaled_w = std::max(static_cast<uint32_t>(rotated_w * scale_factor),
+                                       input.width);
+    const uint32_t scaled_h = std::max(static_cast<uint32_t>(rotated_h * scale_factor),
+                                       input.height);
+    const std::vector<uint8_t> scaled = scale(rotated, rotated_w, rotated_h, scaled_w, scaled_h);
+    const std::vector<uint8_t> cropped = crop(scaled, scaled_w, (scaled_w - input.width) / 2,
+                                              (scaled_h - input.height) / 2, input.width,
+                                              input.height);
+
+    if (std::is_same<T, uint8_t>::value) {
+        convert_rgba_to_uint8(cropped.data(), input.width * 4, input.width, input.height,
+                              PREPROCESS_LAYER_HWC, input.offset, input.scale,
+                              reinterpret_cast<uint8_t *>(dst));
+    } else {
+        convert_rgba_to_float(cropped.data(), input.width * 4, input.width, input.height,
+                              PREPROCESS_LAYER_HWC, input.offset, input.scale,
+                              reinterpret_cast<float *>(dst));
+    }
+}
+
+template <typename T>
+void run_fused(const Frame &frame, const ModelInput &input, T *dst) {
+    if (std::is_same<T, uint8_t>::value) {
+        convert_frame_to_uint8(frame.pixels.data(), frame.stride, frame.width, frame.height,
+                               ROTATION, input.width, input.height, PREPROCESS_LAYER_HWC,
+                               input.offset, input.scale, reinterpret_cast<uint8_t *>(dst));
+    } else {
+        convert_frame_to_float(frame.pixels.data(), frame.stride, frame.width, frame.height,
+                               ROTATION, input.width, input.height, PREPROCESS_LAYER_HWC,
+                               input.offset, input.scale, reinterpret_cast<float *>(dst));
+    }
+}
+
+// Median of repeat timed calls in microseconds
+double median_us(const std::function<void()> &run, int warmup, int repeat) {
+    std::vector<double> samples;
+
+    for (int i = 0; i < warmup; i++) run();
+    for (int i = 0; i < repeat; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    return samples[samples.size() / 2];
+}
+
+template <typename T>
+void benchmark(const Frame &frame, const ModelInput &input, int warmup, int repeat) {
+    const size_t count = static_cast<size_t>(input.width) * input.height * 3;
+    std::vector<uint8_t> bitmap_buffer(static_cast<size_t>(frame.width) * frame.height * 4);
+    std::vector<T> chain_output(count), fused_output(count);
+
+    const double chain_us = median_us([&] {
+        run_chain(frame, &bitmap_buffer, input, chain_output.data());
+    }, warmup, repeat);
+    const double fused_us = median_us([&] {
+        run_fused(frame, input, fused_output.data());
+    }, warmup, repeat);
+
+    double max_difference = 0;
+    for (size_t i = 0; i < count; i++) {
+        max_difference = std::max(max_difference, std::fabs(static_cast<double>(chain_output[i]) -
+                                                            fused_output[i]));
+    }
+
+    char frame_name[32];
+    snprintf(frame_name, sizeof(frame_name), "%ux%u", frame.width, frame.height);
+    printf("%-22s %-10s %4ux%-4u %-7s %10.1f %10.1f %8.2fx %9.3g\n", input.app, frame_name,
+           input.width, input.height, input.quantized ? "uint8" : "float32", chain_us, fused_us,
+           chain_us / fused_us, max_difference);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int warmup = 5;
+    int repeat = 50;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) {
+            warmup = std::max(0, atoi(argv[++i]));
+        } else {
+            fprintf(stderr, "Usage: %s [--repeat N] [--warmup N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%-22s %-10s %-9s %-7s %10s %10s %9s %9s\n", "app", "frame", "input", "type",
+           "chain_us", "fused_us", "speedup", "max_diff");
+
+    uint32_t seed = 1;
+    for (const FrameSize &size : FRAME_SIZES) {
+        const Frame frame = make_frame(size.width, size.height, seed++);
+
+        for (const ModelInput &input : MODEL_INPUTS) {
+            if (input.quantized) {
+                benchmark<uint8_t>(frame, input, warmup, repeat);
+            } else {
+                benchmark<float>(frame, input, warmup, repeat);
+            }
+        }
+    }
+
+    return 0;
+}
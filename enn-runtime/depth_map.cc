@@ -0,0 +1,71 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "depth_map.h"
+
+#include <algorithm>
+
+namespace {
+
+// Rounded a * b / 255, as Skia premultiplies colors
+inline uint32_t multiply_alpha(uint32_t component, uint32_t alpha) {
+    const uint32_t product = component * alpha + 128;
+    return (product + (product >> 8)) >> 8;
+}
+
+inline uint32_t pack_pixel(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+    // RGBA_8888 is stored as R, G, B, A bytes
+    return multiply_alpha(r, a) | (multiply_alpha(g, a) << 8) | (multiply_alpha(b, a) << 16) |
+           (a << 24);
+}
+
+void build_colormap(DepthColormap colormap, uint32_t *lut) {
+    for (uint32_t value = 0; value < 256; value++) {
+        if (colormap == DEPTH_COLORMAP_GRAYSCALE) {
+            lut[value] = pack_pixel(255, value, value, value);
+        } else {
+            lut[value] = pack_pixel(220, 255 - value, value, 255);
+        }
+    }
+}
+
+inline int32_t normalize(float value, float min, float extent) {
+    const float normalized = 255 * ((value - min) / extent);
+    if (!(normalized > 0.0f)) {
+        return 0;
+    }
+    return normalized >= 255.0f ? 255 : static_cast<int32_t>(normalized);
+}
+
+}  // namespace
+
+DepthRange find_depth_range(const float *depth, uint32_t count) {
+    DepthRange range = {depth[0], depth[0]};
+
+    for (uint32_t i = 1; i < count; i++) {
+        range.min = std::min(range.min, depth[i]);
+        range.max = std::max(range.max, depth[i]);
+    }
+    return range;
+}
+
+DepthRange depth_to_pixels(const float *depth, uint32_t width, uint32_t height, DepthRange range,
+                           DepthColormap colormap, uint8_t *dst, uint32_t dst_stride) {
+    uint32_t lut[256];
+    build_colormap(colormap, lut);
+
+    const float extent = range.max - range.min;
+    DepthRange frame = {depth[0], depth[0]};
+
+    for (uint32_t y = 0; y < height; y++) {
+        const float *row = depth + static_cast<uint64_t>(y) * width;
+        auto *out = reinterpret_cast<uint32_t *>(dst + static_cast<uint64_t>(y) * dst_stride);
+
+        for (uint32_t x = 0; x < width; x++) {
+            frame.min = std::min(frame.min, row[x]);
+            frame.max = std::max(frame.max, row[x]);
+            out[x] = lut[normalize(row[x], range.min, extent)];
+        }
+    }
+
+    return frame;
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+// Same order as data/DepthColormap.kt
+enum DepthColormap {
+    DEPTH_COLORMAP_OVERLAY = 0,
+    DEPTH_COLORMAP_GRAYSCALE = 1,
+};
+
+struct DepthRange {
+    float min;
+    float max;
+};
+
+/**
+ * @brief Finds the smallest and largest depth of a frame.
+ *
+ * @param depth Pointer to count depth values.
+ * @param count Number of values, at least 1.
+ * @return Range of the values.
+ */
+DepthRange find_depth_range(const float *depth, uint32_t count);
+
+/**
+ * @brief Normalizes depth to 0..255 and writes it as colored pixels.
+ *
+ * Each value is mapped to int(255 * (value - range.min) / (range.max - range.min)),
+ * clamped to 0..255, and looked up in the colormap. The range of the frame
+ * itself is measured in the same pass so that a cached range can be used
+ * for normalization without a separate scan.
+ *
+ * @param depth Pointer to width * height depth values.
+ * @param width Number of values per row.
+ * @param height Number of rows.
+ * @param range Range mapped to 0..255.
+ * @param colormap Color of each normalized value.
+ * @param dst Pointer to the first row of an RGBA_8888 premultiplied bitmap.
+ * @param dst_stride Distance between rows of dst in bytes.
+ * @return Range of the frame.
+ */
+DepthRange depth_to_pixels(const float *depth, uint32_t width, uint32_t height, DepthRange range,
+                           DepthColormap colormap, uint8_t *dst, uint32_t dst_stride);
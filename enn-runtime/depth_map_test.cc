@@ -0,0 +1,145 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks find_depth_range and depth_to_pixels against a scalar reference of the Kotlin
+// postProcess they replaced: int(255 * (value - min) / (max - min)), clamped to 0..255
+// and colored with the premultiplied overlay or grayscale colormap. The sizes cover
+// single pixels and rows and the 256x256 output of MiDaS; the ranges cover the frame's
+// own, a cached narrower one whose values clamp, and an empty one.
+//
+//   depth_map_test
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "depth_map.h"
+#include "test_helpers.h"
+
+namespace {
+
+// Value of the bytes after each row, which must not be written
+constexpr uint8_t kCanary = 0xA5;
+constexpr uint32_t kRowPadding = 12;
+
+struct Size {
+    uint32_t width;
+    uint32_t height;
+};
+
+const Size SIZES[] = {{1, 1}, {3, 1}, {4, 1}, {5, 2}, {17, 3}, {1, 9}, {256, 256}};
+
+// Depths of MiDaS, which are relative and unbounded. A NaN maps to 0 and leaves the
+// range as it is, since it never compares smaller or larger.
+const float VALUES[] = {
+        412.5f, 0.0f, 1800.25f, -3.5f, 977.0f, 1800.25f, 12.0f, 640.75f, 1e-3f, 255.0f,
+        std::numeric_limits<float>::quiet_NaN(), 1200.0f, 3.0f,
+};
+
+// Alpha-premultiplied RGBA_8888 pixel, rounded to nearest
+uint32_t reference_pixel(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+    const auto premultiply = [a](uint32_t component) {
+        return static_cast<uint32_t>(std::lround(component * a / 255.0));
+    };
+    return premultiply(r) | premultiply(g) << 8 | premultiply(b) << 16 | a << 24;
+}
+
+uint32_t reference_color(int32_t level, DepthColormap colormap) {
+    const auto value = static_cast<uint32_t>(level);
+    if (colormap == DEPTH_COLORMAP_GRAYSCALE) {
+        return reference_pixel(255, value, value, value);
+    }
+    return reference_pixel(220, 255 - value, value, 255);
+}
+
+int32_t reference_level(float value, DepthRange range) {
+    const float extent = range.max - range.min;
+    const float normalized = 255 * ((value - range.min) / extent);
+
+    if (std::isnan(normalized) || normalized <= 0.0f) {
+        return 0;
+    }
+    if (normalized >= 255.0f) {
+        return 255;
+    }
+    return static_cast<int32_t>(normalized);
+}
+
+DepthRange reference_range(const std::vector<float> &depth) {
+    DepthRange range = {depth[0], depth[0]};
+
+    for (float value : depth) {
+        if (value < range.min) {
+            range.min = value;
+        }
+        if (value > range.max) {
+            range.max = value;
+        }
+    }
+    return range;
+}
+
+bool same_range(DepthRange a, DepthRange b) {
+    return a.min == b.min && a.max == b.max;
+}
+
+void check_depth(const Size &size, DepthRange range, DepthColormap colormap) {
+    const uint32_t count = size.width * size.height;
+    const uint32_t stride = size.width * 4 + kRowPadding;
+    const uint32_t value_count = sizeof(VALUES) / sizeof(VALUES[0]);
+
+    std::vector<float> depth(count);
+    for (uint32_t i = 0; i < count; i++) {
+        depth[i] = VALUES[(i * 3 + i / 4) % value_count];
+    }
+    const DepthRange frame = reference_range(depth);
+    if (std::isnan(range.min)) {
+        range = frame;
+    }
+
+    std::vector<uint8_t> expected(stride * size.height, kCanary);
+    for (uint32_t y = 0; y < size.height; y++) {
+        for (uint32_t x = 0; x < size.width; x++) {
+            const uint32_t color =
+                    reference_color(reference_level(depth[y * size.width + x], range), colormap);
+            uint8_t *out = &expected[y * stride + x * 4];
+
+            for (uint32_t byte = 0; byte < 4; byte++) {
+                out[byte] = static_cast<uint8_t>(color >> (8 * byte));
+            }
+        }
+    }
+
+    std::vector<uint8_t> output(stride * size.height, kCanary);
+    const DepthRange measured = depth_to_pixels(depth.data(), size.width, size.height, range,
+                                                colormap, output.data(), stride);
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < output.size(); i++) {
+        mismatches += output[i] != expected[i];
+    }
+    EXPECT_TRUE(mismatches == 0, "%ux%u, range %g..%g, colormap %d: %u bytes differ",
+                size.width, size.height, range.min, range.max, colormap, mismatches);
+    EXPECT_TRUE(same_range(measured, frame), "%ux%u: frame range %g..%g, expected %g..%g",
+                size.width, size.height, measured.min, measured.max, frame.min, frame.max);
+
+    const DepthRange found = find_depth_range(depth.data(), count);
+    EXPECT_TRUE(same_range(found, frame), "%ux%u: found range %g..%g, expected %g..%g",
+                size.width, size.height, found.min, found.max, frame.min, frame.max);
+}
+
+}  // namespace
+
+int main() {
+    // NaN stands for the range of the frame itself
+    const DepthRange ranges[] = {{NAN, NAN}, {100.0f, 1000.0f}, {640.75f, 640.75f}};
+
+    for (const Size &size : SIZES) {
+        for (const DepthRange &range : ranges) {
+            for (DepthColormap colormap : {DEPTH_COLORMAP_OVERLAY, DEPTH_COLORMAP_GRAYSCALE}) {
+                check_depth(size, range, colormap);
+            }
+        }
+    }
+
+    return TestResult("depth_map_test");
+}
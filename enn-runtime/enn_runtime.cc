@@ -0,0 +1,751 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "enn_runtime.h"
+
+#include <android/bitmap.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "include/enn_api-public_ndk_v1.hpp"
+#include "include/enn_api-type_ndk_v1.h"
+#include "camera_frame.h"
+#include "jni_helpers.h"
+#include "preprocess.h"
+
+namespace {
+
+// Buffer set returned to Kotlin as BufferSetInfo.buffer_set. The jlong is a handle to
+// this object rather than the raw EnnBufferPtr array, so the native side knows the
+// layer count of every set it is passed.
+struct EnnBufferSet {
+    EnnBufferPtr *buffers;
+    NumberOfBuffersInfo buffers_info;
+};
+
+// <package>/enn_type/BufferSetInfo, resolved once by RegisterEnnRuntime. FindClass is
+// only reliable there, since native threads resolve against the system class loader.
+struct BufferSetInfoClass {
+    jclass clazz;
+    jmethodID constructor;
+    jfieldID buffer_set;
+    jfieldID n_in_buf;
+    jfieldID n_out_buf;
+};
+
+std::string g_buffer_set_info_name;
+BufferSetInfoClass g_buffer_set_info = {};
+
+bool CacheBufferSetInfoClass(JNIEnv *env) {
+    jclass clazz = env->FindClass(g_buffer_set_info_name.c_str());
+    if (clazz == nullptr) {
+        return false;
+    }
+
+    if (g_buffer_set_info.clazz != nullptr) {
+        env->DeleteGlobalRef(g_buffer_set_info.clazz);
+    }
+    g_buffer_set_info.clazz = static_cast<jclass>(env->NewGlobalRef(clazz));
+    env->DeleteLocalRef(clazz);
+
+    g_buffer_set_info.constructor = env->GetMethodID(g_buffer_set_info.clazz, "<init>", "()V");
+    g_buffer_set_info.buffer_set = env->GetFieldID(g_buffer_set_info.clazz, "buffer_set", "J");
+    g_buffer_set_info.n_in_buf = env->GetFieldID(g_buffer_set_info.clazz, "n_in_buf", "I");
+    g_buffer_set_info.n_out_buf = env->GetFieldID(g_buffer_set_info.clazz, "n_out_buf", "I");
+
+    return g_buffer_set_info.constructor && g_buffer_set_info.buffer_set &&
+           g_buffer_set_info.n_in_buf && g_buffer_set_info.n_out_buf;
+}
+
+jobject EnnBufferSetToBufferSetInfo(
+        JNIEnv *env,
+        EnnBufferSet *buffer_set
+) {
+    jobject jobj = env->NewObject(g_buffer_set_info.clazz, g_buffer_set_info.constructor);
+
+    env->SetLongField(jobj, g_buffer_set_info.buffer_set, reinterpret_cast<jlong>(buffer_set));
+    env->SetIntField(jobj, g_buffer_set_info.n_in_buf, (int) buffer_set->buffers_info.n_in_buf);
+    env->SetIntField(jobj, g_buffer_set_info.n_out_buf, (int) buffer_set->buffers_info.n_out_buf);
+
+    return jobj;
+}
+
+// Buffer of a layer in a buffer set handle, nullptr if the layer does not exist
+EnnBufferPtr LayerBuffer(jlong j_buffer_set, jint layer_number) {
+    auto *buffer_set = reinterpret_cast<EnnBufferSet *>(j_buffer_set);
+    const NumberOfBuffersInfo &info = buffer_set->buffers_info;
+
+    if (layer_number < 0 ||
+        static_cast<uint32_t>(layer_number) >= info.n_in_buf + info.n_out_buf) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Layer %d out of range", layer_number);
+        return nullptr;
+    }
+
+    return buffer_set->buffers[layer_number];
+}
+
+// Applies the key=value preferences written by
+// enn_nnc_model_tester --sweep-preferences, a missing file keeps the defaults
+void LoadPreferences(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return;
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        char key[64];
+        int value;
+
+        if (line[0] == '#' || sscanf(line, " %63[^= \t] = %i", key, &value) != 2) {
+            continue;
+        }
+
+        EnnReturn result;
+        if (!strcmp(key, "perf_mode")) {
+            result = enn::api::EnnSetPreferencePerfMode(value);
+        } else if (!strcmp(key, "core_affinity")) {
+            result = enn::api::EnnSetPreferenceCoreAffinity(value);
+        } else if (!strcmp(key, "preset_id")) {
+            result = enn::api::EnnSetPreferencePresetId(value);
+        } else if (!strcmp(key, "perf_config_id")) {
+            result = enn::api::EnnSetPreferencePerfConfigId(value);
+        } else if (!strcmp(key, "priority")) {
+            result = enn::api::EnnSetPreferencePriority(value);
+        } else {
+            __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unknown preference [%s]", key);
+            continue;
+        }
+
+        if (result) {
+            __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Setting preference [%s] Failed", key);
+        }
+    }
+    fclose(file);
+}
+
+void ennInitialize(
+        JNIEnv *env,
+        jobject thiz,
+        jstring j_preferences_path
+) {
+    if (enn::api::EnnInitialize()) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnInitialize Failed");
+        return;
+    }
+
+    const char *preferences_path = env->GetStringUTFChars(j_preferences_path, 0);
+    LoadPreferences(preferences_path);
+    env->ReleaseStringUTFChars(j_preferences_path, preferences_path);
+}
+
+void ennDeinitialize(
+        JNIEnv *env,
+        jobject thiz
+) {
+    if (enn::api::EnnDeinitialize()) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnDeinitialize Failed");
+    }
+}
+
+jlong ennOpenModel(
+        JNIEnv *env,
+        jobject thiz,
+        jstring j_filename
+) {
+    EnnModelId model_id;
+    const char *filename = env->GetStringUTFChars(j_filename, 0);
+
+    if (enn::api::EnnOpenModel(filename, &model_id)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnOpenModel of [%s] Failed", filename);
+    }
+    env->ReleaseStringUTFChars(j_filename, filename);
+
+    return static_cast<jlong>(model_id);
+}
+
+void ennCloseModel(
+        JNIEnv *env,
+        jobject thiz,
+        jlong model_id
+) {
+    if (enn::api::EnnCloseModel(model_id)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnCloseModel Failed");
+    }
+}
+
+jobject ennAllocateAllBuffers(
+        JNIEnv *env,
+        jobject thiz,
+        jlong model_id
+) {
+    auto *buffer_set = new EnnBufferSet();
+
+    if (enn::api::EnnAllocateAllBuffers(model_id, &buffer_set->buffers,
+                                        &buffer_set->buffers_info)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnAllocateAllBuffers Failed");
+        delete buffer_set;
+        return nullptr;
+    }
+
+    return EnnBufferSetToBufferSetInfo(env, buffer_set);
+}
+
+void ennReleaseBuffers(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_buffers_set,
+        jint buffer_size
+) {
+    auto *buffer_set = reinterpret_cast<EnnBufferSet *>(j_buffers_set);
+
+    if (enn::api::EnnReleaseBuffers(buffer_set->buffers, buffer_size)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnReleaseBuffers Failed");
+    }
+    delete buffer_set;
+}
+
+void ennExecute(
+        JNIEnv *env,
+        jobject thiz,
+        jlong model_id
+) {
+    if (enn::api::EnnExecuteModel(model_id)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnExecuteModel Failed");
+    }
+}
+
+jobject ennBufferView(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_buffer_set,
+        jint layer_number
+) {
+    EnnBufferPtr buffer = LayerBuffer(j_buffer_set, layer_number);
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+
+    // Direct ByteBuffer over the ENN buffer itself, valid until the buffer set is released
+    return env->NewDirectByteBuffer(buffer->va, buffer->size);
+}
+
+// Deepest ring ennCreateBufferRing accepts. Sessions 1..depth are used on top of session
+// 0, within the 16 buffer spaces per model of the ENN framework, which the simulated
+// runtime of nnc-model-tester models as well.
+constexpr jint kMaxRingDepth = 15;
+
+// Buffer sets committed to sessions 1..depth for pipelined camera streams.
+// Session 0 stays with the buffer set from ennAllocateAllBuffers. One completion thread
+// per ring waits for the executions in submission order and notes when each completed,
+// so the time reported for a frame does not include the wait for the next frame that
+// collects it.
+struct EnnBufferRing {
+    EnnModelId model_id;
+    std::vector<EnnBufferSet> buffer_sets;
+
+    std::thread completer;
+    std::mutex mutex;
+    std::condition_variable changed;
+    // Submitted slots the completion thread has not waited for yet, with their
+    // submission time
+    std::deque<std::pair<jint, std::chrono::steady_clock::time_point>> submitted;
+    // Per slot: whether it is in flight, whether its execution completed, and the
+    // milliseconds from submission to completion, -1 if it failed
+    std::vector<bool> in_flight;
+    std::vector<bool> completed;
+    std::vector<jlong> elapsed;
+    bool stopping = false;
+};
+
+// Body of the completion thread of a ring, returns once the ring is stopping and every
+// submitted execution was waited for
+void CompleteRingExecutions(EnnBufferRing *ring) {
+    std::unique_lock<std::mutex> lock(ring->mutex);
+
+    while (true) {
+        ring->changed.wait(lock, [ring] { return ring->stopping || !ring->submitted.empty(); });
+        if (ring->submitted.empty()) {
+            return;
+        }
+
+        const jint slot = ring->submitted.front().first;
+        const auto submitted = ring->submitted.front().second;
+        ring->submitted.pop_front();
+
+        lock.unlock();
+        jlong elapsed = -1;
+        if (enn::api::EnnExecuteModelWait(ring->model_id, slot + 1)) {
+            __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnExecuteModelWait Failed");
+        } else {
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - submitted).count();
+        }
+        lock.lock();
+
+        ring->completed[slot] = true;
+        ring->elapsed[slot] = elapsed;
+        ring->changed.notify_all();
+    }
+}
+
+// Whether slot is a session of the ring
+bool RingSlotInRange(const EnnBufferRing *ring, jint slot) {
+    if (slot < 0 || static_cast<size_t>(slot) >= ring->buffer_sets.size()) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Ring slot %d out of range", slot);
+        return false;
+    }
+
+    return true;
+}
+
+jlong ennCreateBufferRing(
+        JNIEnv *env,
+        jobject thiz,
+        jlong model_id,
+        jint depth
+) {
+    if (depth <= 0 || depth > kMaxRingDepth) {
+        char message[64];
+        snprintf(message, sizeof(message), "Ring depth %d not in 1..%d", depth, kMaxRingDepth);
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), message);
+        return 0;
+    }
+
+    auto *ring = new EnnBufferRing();
+    ring->model_id = model_id;
+    // Handles into the vector are returned by ennRingBufferSet, so it must not reallocate
+    ring->buffer_sets.reserve(depth);
+
+    for (int slot = 0; slot < depth; slot++) {
+        EnnBufferSet buffer_set;
+
+        if (enn::api::EnnAllocateAllBuffers(model_id, &buffer_set.buffers,
+                                            &buffer_set.buffers_info, slot + 1)) {
+            __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                                "EnnAllocateAllBuffers of session %d Failed", slot + 1);
+            for (const auto &allocated : ring->buffer_sets) {
+                enn::api::EnnReleaseBuffers(allocated.buffers,
+                                            allocated.buffers_info.n_in_buf +
+                                            allocated.buffers_info.n_out_buf);
+            }
+            delete ring;
+            return 0;
+        }
+        ring->buffer_sets.push_back(buffer_set);
+    }
+    ring->in_flight.assign(depth, false);
+    ring->completed.assign(depth, false);
+    ring->elapsed.assign(depth, -1);
+    ring->completer = std::thread(CompleteRingExecutions, ring);
+
+    return reinterpret_cast<jlong>(ring);
+}
+
+jlong ennRingBufferSet(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_ring,
+        jint slot
+) {
+    auto *ring = reinterpret_cast<EnnBufferRing *>(j_ring);
+
+    if (!RingSlotInRange(ring, slot)) {
+        return 0;
+    }
+
+    return reinterpret_cast<jlong>(&ring->buffer_sets[slot]);
+}
+
+void ennRingExecuteAsync(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_ring,
+        jint slot
+) {
+    auto *ring = reinterpret_cast<EnnBufferRing *>(j_ring);
+
+    if (!RingSlotInRange(ring, slot)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(ring->mutex);
+    if (ring->in_flight[slot]) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Ring slot %d already in flight", slot);
+        return;
+    }
+
+    const auto submitted = std::chrono::steady_clock::now();
+    if (enn::api::EnnExecuteModelAsync(ring->model_id, slot + 1)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnExecuteModelAsync Failed");
+        return;
+    }
+
+    ring->in_flight[slot] = true;
+    ring->completed[slot] = false;
+    ring->submitted.emplace_back(slot, submitted);
+    ring->changed.notify_all();
+}
+
+// Milliseconds from submission to completion of the execution of slot, -1 if the
+// slot is not in flight or its execution failed
+jlong ennRingWait(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_ring,
+        jint slot
+) {
+    auto *ring = reinterpret_cast<EnnBufferRing *>(j_ring);
+
+    if (!RingSlotInRange(ring, slot)) {
+        return -1;
+    }
+
+    std::unique_lock<std::mutex> lock(ring->mutex);
+    if (!ring->in_flight[slot]) {
+        return -1;
+    }
+    ring->changed.wait(lock, [ring, slot] { return static_cast<bool>(ring->completed[slot]); });
+    ring->in_flight[slot] = false;
+
+    return ring->elapsed[slot];
+}
+
+void ennReleaseBufferRing(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_ring
+) {
+    auto *ring = reinterpret_cast<EnnBufferRing *>(j_ring);
+
+    // Drain frames still executing before their buffers go away
+    {
+        std::lock_guard<std::mutex> lock(ring->mutex);
+        ring->stopping = true;
+        ring->changed.notify_all();
+    }
+    ring->completer.join();
+
+    for (const EnnBufferSet &buffer_set : ring->buffer_sets) {
+        if (enn::api::EnnReleaseBuffers(buffer_set.buffers, buffer_set.buffers_info.n_in_buf +
+                                                            buffer_set.buffers_info.n_out_buf)) {
+            __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "EnnReleaseBuffers Failed");
+        }
+    }
+
+    delete ring;
+}
+
+void ennConvertBitmapToFloat(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_buffer_set,
+        jint layer_number,
+        jobject bitmap,
+        jint width,
+        jint height,
+        jint layer_type,
+        jfloat offset,
+        jfloat scale
+) {
+    EnnBufferPtr buffer = LayerBuffer(j_buffer_set, layer_number);
+    if (buffer == nullptr) {
+        return;
+    }
+
+    if (static_cast<size_t>(width) * height * 3 * sizeof(float) > buffer->size) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Input of %dx%d does not fit layer %d",
+                            width, height, layer_number);
+        return;
+    }
+
+    uint32_t stride;
+    void *pixels = LockInputBitmap(env, bitmap, width, height, &stride);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    convert_rgba_to_float(
+            static_cast<const uint8_t *>(pixels),
+            stride,
+            width,
+            height,
+            static_cast<PreprocessLayer>(layer_type),
+            offset,
+            scale,
+            static_cast<float *>(buffer->va)
+    );
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+void ennConvertBitmapToUInt8(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_buffer_set,
+        jint layer_number,
+        jobject bitmap,
+        jint width,
+        jint height,
+        jint layer_type,
+        jfloat offset,
+        jfloat scale
+) {
+    EnnBufferPtr buffer = LayerBuffer(j_buffer_set, layer_number);
+    if (buffer == nullptr) {
+        return;
+    }
+
+    if (static_cast<size_t>(width) * height * 3 > buffer->size) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Input of %dx%d does not fit layer %d",
+                            width, height, layer_number);
+        return;
+    }
+
+    uint32_t stride;
+    void *pixels = LockInputBitmap(env, bitmap, width, height, &stride);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    convert_rgba_to_uint8(
+            static_cast<const uint8_t *>(pixels),
+            stride,
+            width,
+            height,
+            static_cast<PreprocessLayer>(layer_type),
+            offset,
+            scale,
+            static_cast<uint8_t *>(buffer->va)
+    );
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+// Frame of ImageAnalysis.OUTPUT_IMAGE_FORMAT_RGBA_8888, nullptr if the plane buffer does not
+// cover it or the rotation is not a multiple of 90 degrees
+const uint8_t *FramePixels(JNIEnv *env, jobject frame, jint frame_width, jint frame_height,
+                           jint row_stride, jint rotation) {
+    const auto *pixels = static_cast<const uint8_t *>(env->GetDirectBufferAddress(frame));
+    const jlong capacity = env->GetDirectBufferCapacity(frame);
+
+    if (pixels == nullptr || frame_width <= 0 || frame_height <= 0 ||
+        row_stride < frame_width * 4 ||
+        capacity < static_cast<jlong>(frame_height - 1) * row_stride + frame_width * 4) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                            "Frame must be a direct buffer of %dx%d RGBA pixels",
+                            frame_width, frame_height);
+        return nullptr;
+    }
+    if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported frame rotation %d",
+                            rotation);
+        return nullptr;
+    }
+
+    return pixels;
+}
+
+void ennConvertFrameToFloat(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_buffer_set,
+        jint layer_number,
+        jobject frame,
+        jint frame_width,
+        jint frame_height,
+        jint row_stride,
+        jint rotation,
+        jint width,
+        jint height,
+        jint layer_type,
+        jfloat offset,
+        jfloat scale
+) {
+    EnnBufferPtr buffer = LayerBuffer(j_buffer_set, layer_number);
+    if (buffer == nullptr) {
+        return;
+    }
+
+    if (static_cast<size_t>(width) * height * 3 * sizeof(float) > buffer->size) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Input of %dx%d does not fit layer %d",
+                            width, height, layer_number);
+        return;
+    }
+
+    const uint8_t *pixels = FramePixels(env, frame, frame_width, frame_height, row_stride,
+                                        rotation);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    convert_frame_to_float(
+            pixels,
+            row_stride,
+            frame_width,
+            frame_height,
+            rotation,
+            width,
+            height,
+            static_cast<PreprocessLayer>(layer_type),
+            offset,
+            scale,
+            static_cast<float *>(buffer->va)
+    );
+}
+
+void ennConvertFrameToUInt8(
+        JNIEnv *env,
+        jobject thiz,
+        jlong j_buffer_set,
+        jint layer_number,
+        jobject frame,
+        jint frame_width,
+        jint frame_height,
+        jint row_stride,
+        jint rotation,
+        jint width,
+        jint height,
+        jint layer_type,
+        jfloat offset,
+        jfloat scale
+) {
+    EnnBufferPtr buffer = LayerBuffer(j_buffer_set, layer_number);
+    if (buffer == nullptr) {
+        return;
+    }
+
+    if (static_cast<size_t>(width) * height * 3 > buffer->size) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Input of %dx%d does not fit layer %d",
+                            width, height, layer_number);
+        return;
+    }
+
+    const uint8_t *pixels = FramePixels(env, frame, frame_width, frame_height, row_stride,
+                                        rotation);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    convert_frame_to_uint8(
+            pixels,
+            row_stride,
+            frame_width,
+            frame_height,
+            rotation,
+            width,
+            height,
+            static_cast<PreprocessLayer>(layer_type),
+            offset,
+            scale,
+            static_cast<uint8_t *>(buffer->va)
+    );
+}
+
+const JNINativeMethod SESSION_METHODS[] = {
+        ENN_NATIVE_METHOD(ennInitialize, "(Ljava/lang/String;)V"),
+        ENN_NATIVE_METHOD(ennDeinitialize, "()V"),
+        ENN_NATIVE_METHOD(ennOpenModel, "(Ljava/lang/String;)J"),
+        ENN_NATIVE_METHOD(ennCloseModel, "(J)V"),
+        ENN_NATIVE_METHOD(ennReleaseBuffers, "(JI)V"),
+        ENN_NATIVE_METHOD(ennExecute, "(J)V"),
+        ENN_NATIVE_METHOD(ennBufferView, "(JI)Ljava/nio/ByteBuffer;"),
+};
+
+const JNINativeMethod PREPROCESS_METHODS[] = {
+        ENN_NATIVE_METHOD(ennConvertBitmapToFloat, "(JILandroid/graphics/Bitmap;IIIFF)V"),
+        ENN_NATIVE_METHOD(ennConvertBitmapToUInt8, "(JILandroid/graphics/Bitmap;IIIFF)V"),
+};
+
+const JNINativeMethod CAMERA_FRAME_METHODS[] = {
+        ENN_NATIVE_METHOD(ennConvertFrameToFloat, "(JILjava/nio/ByteBuffer;IIIIIIIFF)V"),
+        ENN_NATIVE_METHOD(ennConvertFrameToUInt8, "(JILjava/nio/ByteBuffer;IIIIIIIFF)V"),
+};
+
+const JNINativeMethod BUFFER_RING_METHODS[] = {
+        ENN_NATIVE_METHOD(ennCreateBufferRing, "(JI)J"),
+        ENN_NATIVE_METHOD(ennRingBufferSet, "(JI)J"),
+        ENN_NATIVE_METHOD(ennRingExecuteAsync, "(JI)V"),
+        ENN_NATIVE_METHOD(ennRingWait, "(JI)J"),
+        ENN_NATIVE_METHOD(ennReleaseBufferRing, "(J)V"),
+};
+
+}  // namespace
+
+const EnnNativeMethods kEnnPreprocessMethods = ENN_NATIVE_METHODS(PREPROCESS_METHODS);
+const EnnNativeMethods kEnnCameraFrameMethods = ENN_NATIVE_METHODS(CAMERA_FRAME_METHODS);
+const EnnNativeMethods kEnnBufferRingMethods = ENN_NATIVE_METHODS(BUFFER_RING_METHODS);
+
+void *LockInputBitmap(JNIEnv *env, jobject bitmap, jint width, jint height, uint32_t *stride) {
+    AndroidBitmapInfo info;
+
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS ||
+        info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 ||
+        info.width < static_cast<uint32_t>(width) || info.height < static_cast<uint32_t>(height)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Bitmap must be ARGB_8888 of at least %dx%d",
+                            width, height);
+        return nullptr;
+    }
+
+    void *pixels;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "AndroidBitmap_lockPixels Failed");
+        return nullptr;
+    }
+
+    *stride = info.stride;
+    return pixels;
+}
+
+jint RegisterEnnRuntime(JavaVM *vm, const char *package, const EnnNativeMethods *groups,
+                        size_t group_count) {
+    JNIEnv *env;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    const std::string executor_class = std::string(package) + "/executor/ModelExecutor";
+    g_buffer_set_info_name = std::string(package) + "/enn_type/BufferSetInfo";
+
+    if (!CacheBufferSetInfoClass(env)) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Resolving [%s] Failed",
+                            g_buffer_set_info_name.c_str());
+        return JNI_ERR;
+    }
+
+    jclass executor = env->FindClass(executor_class.c_str());
+    if (executor == nullptr) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Class [%s] not found",
+                            executor_class.c_str());
+        return JNI_ERR;
+    }
+
+    // The return type of ennAllocateAllBuffers is the BufferSetInfo of the app
+    const std::string allocate_signature = "(J)L" + g_buffer_set_info_name + ";";
+    const JNINativeMethod allocate_method = {
+            "ennAllocateAllBuffers", allocate_signature.c_str(),
+            reinterpret_cast<void *>(ennAllocateAllBuffers)
+    };
+
+    std::vector<JNINativeMethod> methods(std::begin(SESSION_METHODS), std::end(SESSION_METHODS));
+    methods.push_back(allocate_method);
+    for (size_t i = 0; i < group_count; i++) {
+        methods.insert(methods.end(), groups[i].methods, groups[i].methods + groups[i].count);
+    }
+
+    if (env->RegisterNatives(executor, methods.data(), static_cast<jint>(methods.size()))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "RegisterNatives of [%s] Failed",
+                            executor_class.c_str());
+        return JNI_ERR;
+    }
+    env->DeleteLocalRef(executor);
+
+    return JNI_VERSION_1_6;
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <jni.h>
+#include <cstddef>
+
+// Native methods of a ModelExecutor feature, bound together with RegisterNatives
+struct EnnNativeMethods {
+    const JNINativeMethod *methods;
+    jint count;
+};
+
+// ennConvertBitmapToFloat and ennConvertBitmapToUInt8
+extern const EnnNativeMethods kEnnPreprocessMethods;
+
+// ennConvertFrameToFloat and ennConvertFrameToUInt8, bound by the apps with a camera
+extern const EnnNativeMethods kEnnCameraFrameMethods;
+
+// ennCreateBufferRing, ennRingBufferSet, ennRingExecuteAsync, ennRingWait and
+// ennReleaseBufferRing
+extern const EnnNativeMethods kEnnBufferRingMethods;
+
+// Postprocessing of a single sample, bound by the apps that declare it
+extern const EnnNativeMethods kEnnSelectTopKMethods;
+extern const EnnNativeMethods kEnnDecodeYoloMethods;
+extern const EnnNativeMethods kEnnDecodePoseMethods;
+extern const EnnNativeMethods kEnnSegmentToBitmapMethods;
+extern const EnnNativeMethods kEnnDepthToBitmapMethods;
+extern const EnnNativeMethods kEnnPackOutputToBitmapMethods;
+
+/**
+ * @brief Binds the runtime to the ModelExecutor class of an app.
+ *
+ * Meant to be returned from JNI_OnLoad. The session methods every
+ * ModelExecutor declares (ennInitialize to ennBufferView) are always bound.
+ * Every group must only hold methods the class declares, otherwise
+ * RegisterNatives fails.
+ *
+ * @param vm Java VM passed to JNI_OnLoad.
+ * @param package Package of the app in JNI form, e.g. "com/samsung/segmentation".
+ *                The classes <package>/executor/ModelExecutor and
+ *                <package>/enn_type/BufferSetInfo are looked up.
+ * @param groups Further method groups declared by the ModelExecutor of the app.
+ * @param group_count Number of groups.
+ * @return JNI_VERSION_1_6 on success, JNI_ERR on error.
+ */
+jint RegisterEnnRuntime(JavaVM *vm, const char *package, const EnnNativeMethods *groups,
+                        size_t group_count);
@@ -0,0 +1,24 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <jni.h>
+#include <android/log.h>
+#include <cstdint>
+
+#define LOG_TAG "EnnJNI"
+
+#define ENN_NATIVE_METHOD(name, signature) \
+    { #name, signature, reinterpret_cast<void *>(name) }
+
+#define ENN_NATIVE_METHODS(methods) \
+    { methods, static_cast<jint>(sizeof(methods) / sizeof(methods[0])) }
+
+// Same order as data/DataType.kt
+enum OutputDataType {
+    OUTPUT_DATA_FLOAT32 = 0,
+    OUTPUT_DATA_UINT8 = 1,
+};
+
+// Locks an ARGB_8888 bitmap that covers at least width x height pixels
+void *LockInputBitmap(JNIEnv *env, jobject bitmap, jint width, jint height, uint32_t *stride);
@@ -0,0 +1,203 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "nms.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+constexpr uint32_t kGridSize = 16;
+constexpr uint32_t kScoreBuckets = 256;
+
+inline float area(const YoloDetection &box) {
+    return std::max(box.right - box.left, 0.0f) * std::max(box.bottom - box.top, 0.0f);
+}
+
+inline bool overlaps(const YoloDetection &a, const YoloDetection &b, float iou_threshold) {
+    if (a.class_id != b.class_id) {
+        return false;
+    }
+
+    const float width = std::min(a.right, b.right) - std::max(a.left, b.left);
+    const float height = std::min(a.bottom, b.bottom) - std::max(a.top, b.top);
+    if (width <= 0.0f || height <= 0.0f) {
+        return false;
+    }
+
+    const float intersection = width * height;
+    return intersection > iou_threshold * (area(a) + area(b) - intersection);
+}
+
+void suppress_greedy(std::vector<YoloDetection> *detections, float iou_threshold,
+                     uint32_t max_detections) {
+    std::vector<uint32_t> order(detections->size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [detections](uint32_t a, uint32_t b) {
+        return (*detections)[a].score > (*detections)[b].score;
+    });
+
+    std::vector<YoloDetection> kept;
+    for (uint32_t index : order) {
+        if (kept.size() >= max_detections) {
+            break;
+        }
+
+        const YoloDetection &candidate = (*detections)[index];
+        bool suppressed = false;
+        for (const YoloDetection &box : kept) {
+            if (overlaps(candidate, box, iou_threshold)) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed) {
+            kept.push_back(candidate);
+        }
+    }
+
+    detections->swap(kept);
+}
+
+// Cell range covered by a box, clamped to the grid
+struct CellRange {
+    uint32_t x0, y0, x1, y1;
+};
+
+class DetectionGrid {
+public:
+    explicit DetectionGrid(const std::vector<YoloDetection> &detections) {
+        left_ = top_ = 0.0f;
+        float right = 1.0f, bottom = 1.0f;
+        if (!detections.empty()) {
+            left_ = detections[0].left;
+            top_ = detections[0].top;
+            right = detections[0].right;
+            bottom = detections[0].bottom;
+        }
+        for (const YoloDetection &box : detections) {
+            left_ = std::min(left_, box.left);
+            top_ = std::min(top_, box.top);
+            right = std::max(right, box.right);
+            bottom = std::max(bottom, box.bottom);
+        }
+        cell_w_ = std::max(right - left_, 1.0f) / kGridSize;
+        cell_h_ = std::max(bottom - top_, 1.0f) / kGridSize;
+    }
+
+    CellRange cells(const YoloDetection &box) const {
+        return {cell(box.left, left_, cell_w_), cell(box.top, top_, cell_h_),
+                cell(box.right, left_, cell_w_), cell(box.bottom, top_, cell_h_)};
+    }
+
+    std::vector<uint32_t> &bucket(uint32_t x, uint32_t y) {
+        return buckets_[y * kGridSize + x];
+    }
+
+private:
+    static uint32_t cell(float value, float origin, float size) {
+        const float position = (value - origin) / size;
+        if (!(position > 0.0f)) {
+            return 0;
+        }
+        return std::min(static_cast<uint32_t>(position), kGridSize - 1);
+    }
+
+    float left_, top_, cell_w_, cell_h_;
+    std::vector<uint32_t> buckets_[kGridSize * kGridSize];
+};
+
+void suppress_grid(std::vector<YoloDetection> *detections, float iou_threshold,
+                   uint32_t max_detections) {
+    // Counting sort on the score, highest bucket first
+    float min_score = 0.0f, max_score = 0.0f;
+    if (!detections->empty()) {
+        auto range = std::minmax_element(
+                detections->begin(), detections->end(),
+                [](const YoloDetection &a, const YoloDetection &b) { return a.score < b.score; });
+        min_score = range.first->score;
+        max_score = range.second->score;
+    }
+    const float bucket_scale =
+            max_score > min_score ? (kScoreBuckets - 1) / (max_score - min_score) : 0.0f;
+
+    std::vector<uint32_t> bucket_of(detections->size());
+    std::vector<uint32_t> starts(kScoreBuckets + 1, 0);
+    for (size_t i = 0; i < detections->size(); i++) {
+        const float position = ((*detections)[i].score - min_score) * bucket_scale;
+        const uint32_t bucket = position > 0.0f ? static_cast<uint32_t>(position) : 0;
+        bucket_of[i] = kScoreBuckets - 1 - std::min(bucket, kScoreBuckets - 1);
+        starts[bucket_of[i] + 1]++;
+    }
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+
+    std::vector<uint32_t> order(detections->size());
+    for (size_t i = 0; i < detections->size(); i++) {
+        order[starts[bucket_of[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // Kept boxes are registered in every cell they cover, so two overlapping
+    // boxes always share at least one cell
+    DetectionGrid grid(*detections);
+    std::vector<YoloDetection> kept;
+    std::vector<uint32_t> last_checked;
+
+    for (uint32_t index : order) {
+        if (kept.size() >= max_detections) {
+            break;
+        }
+
+        const YoloDetection &candidate = (*detections)[index];
+        const CellRange range = grid.cells(candidate);
+        bool suppressed = false;
+
+        // A kept box spanning several cells is compared only once per candidate
+        for (uint32_t y = range.y0; y <= range.y1 && !suppressed; y++) {
+            for (uint32_t x = range.x0; x <= range.x1 && !suppressed; x++) {
+                for (uint32_t k : grid.bucket(x, y)) {
+                    if (last_checked[k] == index) {
+                        continue;
+                    }
+                    last_checked[k] = index;
+                    if (overlaps(candidate, kept[k], iou_threshold)) {
+                        suppressed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (suppressed) {
+            continue;
+        }
+
+        const uint32_t kept_index = static_cast<uint32_t>(kept.size());
+        kept.push_back(candidate);
+        last_checked.push_back(index);
+        for (uint32_t y = range.y0; y <= range.y1; y++) {
+            for (uint32_t x = range.x0; x <= range.x1; x++) {
+                grid.bucket(x, y).push_back(kept_index);
+            }
+        }
+    }
+
+    detections->swap(kept);
+}
+
+}  // namespace
+
+void suppress_overlapping(std::vector<YoloDetection> *detections, NmsMethod method,
+                          float iou_threshold, uint32_t max_detections) {
+    switch (method) {
+        case NMS_METHOD_GREEDY:
+            suppress_greedy(detections, iou_threshold, max_detections);
+            break;
+        case NMS_METHOD_GRID:
+            suppress_grid(detections, iou_threshold, max_detections);
+            break;
+        default:
+            if (detections->size() > max_detections) {
+                detections->resize(max_detections);
+            }
+            break;
+    }
+}
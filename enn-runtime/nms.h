@@ -0,0 +1,33 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "yolo_decoder.h"
+
+// Same order as data/NmsMethod.kt
+enum NmsMethod {
+    NMS_METHOD_NONE = 0,
+    NMS_METHOD_GREEDY = 1,
+    NMS_METHOD_GRID = 2,
+};
+
+/**
+ * @brief Per-class non-maximum suppression.
+ *
+ * A detection is dropped when it overlaps a higher scoring kept detection
+ * of the same class by more than iou_threshold. NMS_METHOD_GREEDY visits
+ * the detections in exact score order. NMS_METHOD_GRID orders them with a
+ * counting sort over score buckets and only compares boxes sharing a cell
+ * of a coarse spatial grid, so candidates within one bucket are visited in
+ * decode order.
+ *
+ * @param detections Decoded boxes, replaced by the kept boxes in visiting order.
+ * @param method Suppression method.
+ * @param iou_threshold Maximum allowed intersection over union.
+ * @param max_detections Maximum number of kept boxes.
+ */
+void suppress_overlapping(std::vector<YoloDetection> *detections, NmsMethod method,
+                          float iou_threshold, uint32_t max_detections);
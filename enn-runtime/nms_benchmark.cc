@@ -0,0 +1,170 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Measures decode_yolo_output and suppress_overlapping on dense synthetic YOLOv5
+// outputs of 25200 anchors and 80 classes, where thousands of candidates survive the
+// threshold. Objects are placed at random and every anchor near one reports it with
+// a jittered box, the way anchors of neighboring cells and scales do. Outputs are
+// generated from a fixed seed, so that runs of the same build can be compared.
+//
+// Every kept list is checked for pairs of the same class that overlap by more than
+// the IoU threshold, and greedy and grid suppression are compared.
+//
+//   enn_runtime_nms_benchmark [--repeat N] [--warmup N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+#include "nms.h"
+#include "yolo_decoder.h"
+
+namespace {
+
+constexpr uint32_t kAnchors = 25200;
+constexpr uint32_t kClasses = 80;
+constexpr uint32_t kRowSize = 5 + kClasses;
+constexpr float kInputSize = 640.0f;
+
+// Settings of object-detection in ModelConstants.kt
+constexpr float kIouThreshold = 0.45f;
+constexpr uint32_t kMaxDetections = 100;
+
+struct Scene {
+    uint32_t objects;
+    float threshold;
+};
+
+// From a typical frame to a crowd scene with a low threshold
+const Scene SCENES[] = {{10, 0.5f}, {50, 0.5f}, {200, 0.25f}, {400, 0.1f}};
+
+std::vector<float> make_output(uint32_t objects, uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> position(0.0f, kInputSize);
+    std::uniform_real_distribution<float> size(16.0f, 160.0f);
+    std::uniform_int_distribution<uint32_t> class_id(0, kClasses - 1);
+    std::uniform_int_distribution<uint32_t> anchor(0, kAnchors - 1);
+    std::normal_distribution<float> jitter(0.0f, 0.08f);
+    std::uniform_real_distribution<float> background(0.0f, 0.05f);
+    std::uniform_real_distribution<float> confidence(0.3f, 1.0f);
+
+    std::vector<float> output(static_cast<size_t>(kAnchors) * kRowSize);
+    for (float &value : output) {
+        value = background(generator);
+    }
+
+    // Each object is reported by 60 anchors, the boxes of which mostly overlap
+    for (uint32_t object = 0; object < objects; object++) {
+        const float cx = position(generator), cy = position(generator);
+        const float w = size(generator), h = size(generator);
+        const uint32_t object_class = class_id(generator);
+
+        for (int i = 0; i < 60; i++) {
+            float *row = &output[static_cast<size_t>(anchor(generator)) * kRowSize];
+            row[0] = cx + w * jitter(generator);
+            row[1] = cy + h * jitter(generator);
+            row[2] = w * (1.0f + jitter(generator));
+            row[3] = h * (1.0f + jitter(generator));
+            row[4] = confidence(generator);
+            row[5 + object_class] = confidence(generator);
+        }
+    }
+
+    return output;
+}
+
+// Number of kept pairs of the same class that overlap by more than the threshold
+uint32_t count_overlapping_pairs(const std::vector<YoloDetection> &kept) {
+    uint32_t pairs = 0;
+
+    for (size_t i = 0; i < kept.size(); i++) {
+        for (size_t j = i + 1; j < kept.size(); j++) {
+            const YoloDetection &a = kept[i], &b = kept[j];
+            const float width = std::min(a.right, b.right) - std::max(a.left, b.left);
+            const float height = std::min(a.bottom, b.bottom) - std::max(a.top, b.top);
+            if (a.class_id != b.class_id || width <= 0.0f || height <= 0.0f) {
+                continue;
+            }
+
+            const float intersection = width * height;
+            const float area_a = (a.right - a.left) * (a.bottom - a.top);
+            const float area_b = (b.right - b.left) * (b.bottom - b.top);
+            pairs += intersection > kIouThreshold * (area_a + area_b - intersection);
+        }
+    }
+
+    return pairs;
+}
+
+// Median of repeat timed calls in microseconds
+double median_us(const std::function<void()> &run, int warmup, int repeat) {
+    std::vector<double> samples;
+
+    for (int i = 0; i < warmup; i++) run();
+    for (int i = 0; i < repeat; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int warmup = 3;
+    int repeat = 30;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) {
+            warmup = std::max(0, atoi(argv[++i]));
+        } else {
+            fprintf(stderr, "Usage: %s [--repeat N] [--warmup N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%-8s %-9s %10s %10s %10s %10s %7s %7s %9s\n", "objects", "threshold", "candidates",
+           "decode_us", "greedy_us", "grid_us", "greedy", "grid", "overlaps");
+
+    bool valid = true;
+    uint32_t seed = 1;
+    for (const Scene &scene : SCENES) {
+        const std::vector<float> output = make_output(scene.objects, seed++);
+        std::vector<YoloDetection> candidates, greedy, grid;
+
+        const double decode_us = median_us([&] {
+            decode_yolo_output(output.data(), kAnchors, kRowSize, scene.threshold, &candidates);
+        }, warmup, repeat);
+        const double greedy_us = median_us([&] {
+            greedy = candidates;
+            suppress_overlapping(&greedy, NMS_METHOD_GREEDY, kIouThreshold, kMaxDetections);
+        }, warmup, repeat);
+        const double grid_us = median_us([&] {
+            grid = candidates;
+            suppress_overlapping(&grid, NMS_METHOD_GRID, kIouThreshold, kMaxDetections);
+        }, warmup, repeat);
+
+        const uint32_t overlaps = count_overlapping_pairs(greedy) + count_overlapping_pairs(grid);
+        valid &= overlaps == 0;
+
+        printf("%-8u %-9.2f %10zu %10.1f %10.1f %10.1f %7zu %7zu %9u\n", scene.objects,
+               scene.threshold, candidates.size(), decode_us, greedy_us, grid_us, greedy.size(),
+               grid.size(), overlaps);
+    }
+
+    if (!valid) {
+        fprintf(stderr, "Kept boxes overlap by more than the IoU threshold\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "pose_decoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+inline float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+inline int32_t compute_coordinate(uint32_t position, uint32_t length, uint32_t image_size,
+                                  float offset, float crop, float scale) {
+    const float coordinate = position / static_cast<float>(length - 1) * image_size + offset;
+    return static_cast<int32_t>(coordinate * scale / image_size - crop / 2);
+}
+
+template<typename T>
+void decode_pose(const T *heatmap, const T *offsets, uint32_t rows, uint32_t cols,
+                 uint32_t keypoints, uint32_t input_width, uint32_t input_height, float *result) {
+    // Cell 0 is the fallback, and later cells only win with a strictly greater score
+    std::vector<float> best(heatmap, heatmap + keypoints);
+    std::vector<uint32_t> best_cell(keypoints, 0);
+
+    for (uint32_t cell = 1; cell < rows * cols; cell++) {
+        const T *scores = heatmap + static_cast<size_t>(cell) * keypoints;
+        for (uint32_t k = 0; k < keypoints; k++) {
+            const float score = static_cast<float>(scores[k]);
+            if (score > best[k]) {
+                best[k] = score;
+                best_cell[k] = cell;
+            }
+        }
+    }
+
+    // Non-square inputs are padded to a square crop
+    const bool landscape = input_width > input_height;
+    const float crop_width = landscape ? 0.0f : static_cast<float>(input_height - input_width);
+    const float crop_height = landscape ? static_cast<float>(input_width - input_height) : 0.0f;
+    const float scale = static_cast<float>(std::max(input_width, input_height));
+
+    for (uint32_t k = 0; k < keypoints; k++) {
+        const uint32_t y = best_cell[k] / cols;
+        const uint32_t x = best_cell[k] % cols;
+        const T *offset = offsets + static_cast<size_t>(best_cell[k]) * keypoints * 2;
+
+        result[k * 3 + 0] = static_cast<float>(compute_coordinate(
+                x, cols, input_width, static_cast<float>(offset[k + keypoints]), crop_width, scale));
+        result[k * 3 + 1] = static_cast<float>(compute_coordinate(
+                y, rows, input_height, static_cast<float>(offset[k]), crop_height, scale));
+        result[k * 3 + 2] = sigmoid(best[k]);
+    }
+}
+
+}  // namespace
+
+void decode_single_pose(const float *heatmap, const float *offsets, uint32_t rows, uint32_t cols,
+                        uint32_t keypoints, uint32_t input_width, uint32_t input_height,
+                        float *result) {
+    decode_pose(heatmap, offsets, rows, cols, keypoints, input_width, input_height, result);
+}
+
+void decode_single_pose(const uint8_t *heatmap, const uint8_t *offsets, uint32_t rows,
+                        uint32_t cols, uint32_t keypoints, uint32_t input_width,
+                        uint32_t input_height, float *result) {
+    decode_pose(heatmap, offsets, rows, cols, keypoints, input_width, input_height, result);
+}
\ No newline at end of file
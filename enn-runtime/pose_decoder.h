@@ -0,0 +1,35 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Decodes a single PoseNet pose from heatmap and offset outputs.
+ *
+ * Both outputs are read in place in rows x cols x channels order. All
+ * keypoint maxima are found in one pass over the heatmap, then refined with
+ * the offsets (y in channel k, x in channel k + keypoints) and scored with
+ * a sigmoid. Coordinates are truncated to whole pixels.
+ *
+ * @param heatmap Pointer to rows * cols * keypoints scores.
+ * @param offsets Pointer to rows * cols * 2 * keypoints offsets.
+ * @param rows Heatmap height.
+ * @param cols Heatmap width.
+ * @param keypoints Number of keypoints.
+ * @param input_width Model input width.
+ * @param input_height Model input height.
+ * @param result Receives x, y and score for each keypoint.
+ */
+void decode_single_pose(const float *heatmap, const float *offsets, uint32_t rows, uint32_t cols,
+                        uint32_t keypoints, uint32_t input_width, uint32_t input_height,
+                        float *result);
+
+/**
+ * @brief uint8 variant of decode_single_pose for quantized models.
+ *
+ * Values are used as they are, without dequantization.
+ */
+void decode_single_pose(const uint8_t *heatmap, const uint8_t *offsets, uint32_t rows,
+                        uint32_t cols, uint32_t keypoints, uint32_t input_width,
+                        uint32_t input_height, float *result);
\ No newline at end of file
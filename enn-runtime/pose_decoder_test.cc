@@ -0,0 +1,145 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks decode_single_pose against a scalar reference of the Kotlin postProcess it
+// replaced, which looked up the maximum of each keypoint over rows, then columns, and
+// read its offsets from an Array<Array<FloatArray>> copy of each output. The shapes
+// cover the 9x9x17 output of PoseNet, ties, and square, portrait and landscape inputs.
+//
+//   pose_decoder_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "pose_decoder.h"
+#include "test_helpers.h"
+
+namespace {
+
+struct Shape {
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t keypoints;
+};
+
+const Shape SHAPES[] = {{2, 2, 1}, {3, 5, 2}, {9, 9, 17}, {17, 9, 17}};
+
+struct Input {
+    uint32_t width;
+    uint32_t height;
+};
+
+const Input INPUTS[] = {{257, 257}, {192, 256}, {320, 240}};
+
+template<typename T>
+struct Outputs {
+    std::vector<T> heatmap;
+    std::vector<T> offsets;
+};
+
+// Heatmaps with a few distinct scores, so that several cells tie for a maximum,
+// and offsets that differ per cell and channel
+template<typename T>
+Outputs<T> make_outputs(const Shape &shape, float score_step, float offset_step) {
+    const uint32_t cells = shape.rows * shape.cols;
+    Outputs<T> outputs;
+
+    outputs.heatmap.resize(cells * shape.keypoints);
+    for (uint32_t i = 0; i < outputs.heatmap.size(); i++) {
+        outputs.heatmap[i] = static_cast<T>((i * 13 + i / 5) % 11 * score_step);
+    }
+    outputs.offsets.resize(cells * shape.keypoints * 2);
+    for (uint32_t i = 0; i < outputs.offsets.size(); i++) {
+        outputs.offsets[i] = static_cast<T>((i * 7 + i / 3) % 23 * offset_step);
+    }
+    return outputs;
+}
+
+// computeCoordinate of the Kotlin postProcess
+int32_t reference_coordinate(uint32_t position, uint32_t length, uint32_t image_size,
+                             float offset, float crop, float scale) {
+    const float coordinate = position / static_cast<float>(length - 1) * image_size + offset;
+    return static_cast<int32_t>(coordinate * scale / image_size - crop / 2);
+}
+
+template<typename T>
+std::vector<float> reference_pose(const Outputs<T> &outputs, const Shape &shape,
+                                  const Input &input) {
+    const float scale = static_cast<float>(std::max(input.width, input.height));
+    const bool landscape = input.width > input.height;
+    const float crop_width = landscape ? 0.0f : static_cast<float>(input.height - input.width);
+    const float crop_height = landscape ? static_cast<float>(input.width - input.height) : 0.0f;
+    std::vector<float> result(shape.keypoints * 3);
+
+    for (uint32_t k = 0; k < shape.keypoints; k++) {
+        // maxByOrNull keeps the first of equal maxima
+        uint32_t best_row = 0;
+        uint32_t best_col = 0;
+        float best = static_cast<float>(outputs.heatmap[k]);
+
+        for (uint32_t row = 0; row < shape.rows; row++) {
+            for (uint32_t col = 0; col < shape.cols; col++) {
+                const float score = static_cast<float>(
+                        outputs.heatmap[(row * shape.cols + col) * shape.keypoints + k]);
+                if (score > best) {
+                    best = score;
+                    best_row = row;
+                    best_col = col;
+                }
+            }
+        }
+
+        const T *offset =
+                &outputs.offsets[(best_row * shape.cols + best_col) * shape.keypoints * 2];
+        result[k * 3 + 0] = static_cast<float>(reference_coordinate(
+                best_col, shape.cols, input.width, static_cast<float>(offset[k + shape.keypoints]),
+                crop_width, scale));
+        result[k * 3 + 1] = static_cast<float>(reference_coordinate(
+                best_row, shape.rows, input.height, static_cast<float>(offset[k]), crop_height,
+                scale));
+        result[k * 3 + 2] = 1.0f / (1.0f + std::exp(-best));
+    }
+    return result;
+}
+
+template<typename T>
+void check_pose(const char *type, const Outputs<T> &outputs, const Shape &shape,
+                const Input &input) {
+    const std::vector<float> expected = reference_pose(outputs, shape, input);
+    std::vector<float> result(shape.keypoints * 3, NAN);
+
+    decode_single_pose(outputs.heatmap.data(), outputs.offsets.data(), shape.rows, shape.cols,
+                       shape.keypoints, input.width, input.height, result.data());
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < result.size(); i++) {
+        mismatches += result[i] != expected[i];
+    }
+    EXPECT_TRUE(mismatches == 0, "%s %ux%ux%u, input %ux%u: %u of %zu values differ", type,
+                shape.rows, shape.cols, shape.keypoints, input.width, input.height, mismatches,
+                result.size());
+}
+
+}  // namespace
+
+int main() {
+    for (const Shape &shape : SHAPES) {
+        const Outputs<float> float_outputs = make_outputs<float>(shape, 0.75f, -1.5f);
+        const Outputs<uint8_t> uint8_outputs = make_outputs<uint8_t>(shape, 20.0f, 10.0f);
+
+        for (const Input &input : INPUTS) {
+            check_pose("float", float_outputs, shape, input);
+            check_pose("uint8", uint8_outputs, shape, input);
+        }
+    }
+
+    // A maximum in the last cell, and negative scores everywhere else
+    const Shape shape = {9, 9, 17};
+    Outputs<float> outputs = make_outputs<float>(shape, -0.5f, 2.0f);
+    for (uint32_t k = 0; k < shape.keypoints; k++) {
+        outputs.heatmap[(shape.rows * shape.cols - 1) * shape.keypoints + k] = 4.0f;
+    }
+    check_pose("last cell", outputs, shape, INPUTS[0]);
+
+    return TestResult("pose_decoder_test");
+}
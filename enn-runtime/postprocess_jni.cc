@@ -0,0 +1,383 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include <android/bitmap.h>
+#include <cmath>
+#include <vector>
+#include "argb_pack.h"
+#include "depth_map.h"
+#include "enn_runtime.h"
+#include "jni_helpers.h"
+#include "nms.h"
+#include "pose_decoder.h"
+#include "segment_mask.h"
+#include "top_k.h"
+#include "yolo_decoder.h"
+
+namespace {
+
+jfloatArray ennSelectTopK(
+        JNIEnv *env,
+        jobject thiz,
+        jobject output,
+        jint data_type,
+        jint count,
+        jint k,
+        jfloat threshold,
+        jfloat offset,
+        jfloat scale,
+        jfloatArray j_dequantize
+) {
+    const void *data = env->GetDirectBufferAddress(output);
+    const size_t element_size = data_type == OUTPUT_DATA_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+
+    if (data == nullptr || k < 0 ||
+        static_cast<size_t>(count) * element_size >
+        static_cast<size_t>(env->GetDirectBufferCapacity(output))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Output does not hold %d values", count);
+        return env->NewFloatArray(0);
+    }
+
+    std::vector<ScoredClass> selected;
+    if (data_type == OUTPUT_DATA_FLOAT32) {
+        select_top_k(static_cast<const float *>(data), count, k, threshold, offset, scale,
+                     &selected);
+    } else if (data_type == OUTPUT_DATA_UINT8 && env->GetArrayLength(j_dequantize) >= 256) {
+        jfloat dequantize[256];
+        env->GetFloatArrayRegion(j_dequantize, 0, 256, dequantize);
+        select_top_k(static_cast<const uint8_t *>(data), count, k, threshold, offset, scale,
+                     dequantize, &selected);
+    } else {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported output data type: %d",
+                            data_type);
+    }
+
+    // index, score per selected class
+    std::vector<jfloat> packed(selected.size() * 2);
+    for (size_t i = 0; i < selected.size(); i++) {
+        packed[i * 2] = static_cast<jfloat>(selected[i].index);
+        packed[i * 2 + 1] = selected[i].score;
+    }
+
+    jfloatArray result = env->NewFloatArray(static_cast<jsize>(packed.size()));
+    env->SetFloatArrayRegion(result, 0, static_cast<jsize>(packed.size()), packed.data());
+    return result;
+}
+
+jfloatArray ennDecodeYolo(
+        JNIEnv *env,
+        jobject thiz,
+        jobject output,
+        jint data_type,
+        jint num_anchors,
+        jint row_size,
+        jfloat threshold,
+        jint nms_method,
+        jfloat iou_threshold,
+        jint max_detections
+) {
+    const void *data = env->GetDirectBufferAddress(output);
+    const size_t element_size = data_type == OUTPUT_DATA_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+
+    if (data == nullptr ||
+        static_cast<size_t>(num_anchors) * row_size * element_size >
+        static_cast<size_t>(env->GetDirectBufferCapacity(output))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Output does not hold %dx%d values",
+                            num_anchors, row_size);
+        return env->NewFloatArray(0);
+    }
+
+    std::vector<YoloDetection> detections;
+    if (data_type == OUTPUT_DATA_FLOAT32) {
+        decode_yolo_output(static_cast<const float *>(data), num_anchors, row_size, threshold,
+                           &detections);
+    } else if (data_type == OUTPUT_DATA_UINT8) {
+        decode_yolo_output(static_cast<const uint8_t *>(data), num_anchors, row_size, threshold,
+                           &detections);
+    } else {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported output data type: %d",
+                            data_type);
+    }
+
+    suppress_overlapping(&detections, static_cast<NmsMethod>(nms_method), iou_threshold,
+                         static_cast<uint32_t>(max_detections));
+
+    // left, top, right, bottom, score, class per detection
+    const jsize packed_size = static_cast<jsize>(detections.size() * 6);
+    std::vector<jfloat> packed(packed_size);
+    for (size_t i = 0; i < detections.size(); i++) {
+        const YoloDetection &detection = detections[i];
+        packed[i * 6 + 0] = detection.left;
+        packed[i * 6 + 1] = detection.top;
+        packed[i * 6 + 2] = detection.right;
+        packed[i * 6 + 3] = detection.bottom;
+        packed[i * 6 + 4] = detection.score;
+        packed[i * 6 + 5] = static_cast<jfloat>(detection.class_id);
+    }
+
+    jfloatArray result = env->NewFloatArray(packed_size);
+    env->SetFloatArrayRegion(result, 0, packed_size, packed.data());
+    return result;
+}
+
+jfloatArray ennDecodePose(
+        JNIEnv *env,
+        jobject thiz,
+        jobject heatmap,
+        jobject offsets,
+        jint data_type,
+        jint rows,
+        jint cols,
+        jint keypoints,
+        jint input_width,
+        jint input_height
+) {
+    const void *heatmap_data = env->GetDirectBufferAddress(heatmap);
+    const void *offset_data = env->GetDirectBufferAddress(offsets);
+    const size_t element_size = data_type == OUTPUT_DATA_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+    const size_t heatmap_size = static_cast<size_t>(rows) * cols * keypoints * element_size;
+
+    if (heatmap_data == nullptr || offset_data == nullptr ||
+        heatmap_size > static_cast<size_t>(env->GetDirectBufferCapacity(heatmap)) ||
+        heatmap_size * 2 > static_cast<size_t>(env->GetDirectBufferCapacity(offsets))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Outputs do not hold %dx%dx%d keypoints",
+                            rows, cols, keypoints);
+        return env->NewFloatArray(0);
+    }
+
+    // x, y, score per keypoint
+    std::vector<jfloat> result(static_cast<size_t>(keypoints) * 3);
+    if (data_type == OUTPUT_DATA_FLOAT32) {
+        decode_single_pose(static_cast<const float *>(heatmap_data),
+                           static_cast<const float *>(offset_data), rows, cols, keypoints,
+                           input_width, input_height, result.data());
+    } else if (data_type == OUTPUT_DATA_UINT8) {
+        decode_single_pose(static_cast<const uint8_t *>(heatmap_data),
+                           static_cast<const uint8_t *>(offset_data), rows, cols, keypoints,
+                           input_width, input_height, result.data());
+    } else {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported output data type: %d",
+                            data_type);
+    }
+
+    jfloatArray packed = env->NewFloatArray(static_cast<jsize>(result.size()));
+    env->SetFloatArrayRegion(packed, 0, static_cast<jsize>(result.size()), result.data());
+    return packed;
+}
+
+void ennSegmentToBitmap(
+        JNIEnv *env,
+        jobject thiz,
+        jobject output,
+        jint data_type,
+        jint width,
+        jint height,
+        jint channels,
+        jfloat offset,
+        jfloat scale,
+        jintArray colors,
+        jobject mask
+) {
+    const void *data = env->GetDirectBufferAddress(output);
+    const size_t element_size = data_type == OUTPUT_DATA_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+
+    if (data == nullptr ||
+        static_cast<size_t>(width) * height * channels * element_size >
+        static_cast<size_t>(env->GetDirectBufferCapacity(output))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Output does not hold %dx%dx%d values",
+                            width, height, channels);
+        return;
+    }
+
+    const jsize color_count = env->GetArrayLength(colors);
+    if (channels > color_count) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "%d colors for %d classes", color_count,
+                            channels);
+        return;
+    }
+
+    std::vector<jint> color_values(color_count);
+    std::vector<uint32_t> palette(color_count);
+    env->GetIntArrayRegion(colors, 0, color_count, color_values.data());
+    premultiply_palette(color_values.data(), color_count, palette.data());
+
+    uint32_t stride;
+    void *pixels = LockInputBitmap(env, mask, width, height, &stride);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    if (data_type == OUTPUT_DATA_FLOAT32) {
+        argmax_to_palette(static_cast<const float *>(data), width, height, channels,
+                          palette.data(), static_cast<uint8_t *>(pixels), stride);
+    } else if (data_type == OUTPUT_DATA_UINT8) {
+        argmax_to_palette(static_cast<const uint8_t *>(data), width, height, channels, offset,
+                          scale, palette.data(), static_cast<uint8_t *>(pixels), stride);
+    } else {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported output data type: %d",
+                            data_type);
+    }
+
+    AndroidBitmap_unlockPixels(env, mask);
+}
+
+void ennDepthToBitmap(
+        JNIEnv *env,
+        jobject thiz,
+        jobject output,
+        jint data_type,
+        jint width,
+        jint height,
+        jfloat offset,
+        jfloat scale,
+        jint colormap,
+        jfloatArray j_range,
+        jfloat ema_alpha,
+        jobject mask
+) {
+    const void *data = env->GetDirectBufferAddress(output);
+    const size_t count = static_cast<size_t>(width) * height;
+    const size_t element_size = data_type == OUTPUT_DATA_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+
+    if (data == nullptr || count == 0 ||
+        count * element_size > static_cast<size_t>(env->GetDirectBufferCapacity(output))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Output does not hold %dx%d values",
+                            width, height);
+        return;
+    }
+    if (data_type != OUTPUT_DATA_FLOAT32 && data_type != OUTPUT_DATA_UINT8) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported output data type: %d",
+                            data_type);
+        return;
+    }
+
+    // Raw float outputs are read in place, anything else is dequantized first
+    const float *depth = static_cast<const float *>(data);
+    std::vector<float> dequantized;
+    if (data_type != OUTPUT_DATA_FLOAT32 || offset != 0.0f || scale != 1.0f) {
+        dequantized.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            const float value = data_type == OUTPUT_DATA_FLOAT32
+                                ? static_cast<const float *>(data)[i]
+                                : static_cast<const uint8_t *>(data)[i];
+            dequantized[i] = (value - offset) / scale;
+        }
+        depth = dequantized.data();
+    }
+
+    // range holds the smoothed min and max, NaN until the first frame
+    jfloat range_values[2];
+    env->GetFloatArrayRegion(j_range, 0, 2, range_values);
+    DepthRange range = {range_values[0], range_values[1]};
+    const bool smooth = ema_alpha > 0.0f && !std::isnan(range.min) && !std::isnan(range.max);
+
+    // Without smoothing the exact range of this frame needs its own pass
+    if (!smooth) {
+        range = find_depth_range(depth, static_cast<uint32_t>(count));
+    }
+
+    uint32_t stride;
+    void *pixels = LockInputBitmap(env, mask, width, height, &stride);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    const DepthRange frame = depth_to_pixels(depth, width, height, range,
+                                             static_cast<DepthColormap>(colormap),
+                                             static_cast<uint8_t *>(pixels), stride);
+
+    AndroidBitmap_unlockPixels(env, mask);
+
+    if (smooth) {
+        range.min += ema_alpha * (frame.min - range.min);
+        range.max += ema_alpha * (frame.max - range.max);
+    }
+    range_values[0] = range.min;
+    range_values[1] = range.max;
+    env->SetFloatArrayRegion(j_range, 0, 2, range_values);
+}
+
+void ennPackOutputToBitmap(
+        JNIEnv *env,
+        jobject thiz,
+        jobject output,
+        jint data_type,
+        jint width,
+        jint height,
+        jint layer_type,
+        jfloat scale,
+        jfloat offset,
+        jobject image
+) {
+    const void *data = env->GetDirectBufferAddress(output);
+    const size_t count = static_cast<size_t>(width) * height * 3;
+    const size_t element_size = data_type == OUTPUT_DATA_FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+
+    if (data == nullptr ||
+        count * element_size > static_cast<size_t>(env->GetDirectBufferCapacity(output))) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Output does not hold %dx%dx3 values",
+                            width, height);
+        return;
+    }
+    if (data_type != OUTPUT_DATA_FLOAT32 && data_type != OUTPUT_DATA_UINT8) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "Unsupported output data type: %d",
+                            data_type);
+        return;
+    }
+
+    // Float outputs are read in place, uint8 outputs are widened first
+    const float *values = static_cast<const float *>(data);
+    std::vector<float> widened;
+    if (data_type == OUTPUT_DATA_UINT8) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        widened.assign(bytes, bytes + count);
+        values = widened.data();
+    }
+
+    uint32_t stride;
+    void *pixels = LockInputBitmap(env, image, width, height, &stride);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    pack_float_to_rgba(values, width, height, static_cast<PreprocessLayer>(layer_type), scale,
+                       offset, static_cast<uint8_t *>(pixels), stride);
+
+    AndroidBitmap_unlockPixels(env, image);
+}
+
+const JNINativeMethod SELECT_TOP_K_METHODS[] = {
+        ENN_NATIVE_METHOD(ennSelectTopK, "(Ljava/nio/ByteBuffer;IIIFFF[F)[F"),
+};
+
+const JNINativeMethod DECODE_YOLO_METHODS[] = {
+        ENN_NATIVE_METHOD(ennDecodeYolo, "(Ljava/nio/ByteBuffer;IIIFIFI)[F"),
+};
+
+const JNINativeMethod DECODE_POSE_METHODS[] = {
+        ENN_NATIVE_METHOD(ennDecodePose, "(Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;IIIIII)[F"),
+};
+
+const JNINativeMethod SEGMENT_TO_BITMAP_METHODS[] = {
+        ENN_NATIVE_METHOD(ennSegmentToBitmap,
+                          "(Ljava/nio/ByteBuffer;IIIIFF[ILandroid/graphics/Bitmap;)V"),
+};
+
+const JNINativeMethod DEPTH_TO_BITMAP_METHODS[] = {
+        ENN_NATIVE_METHOD(ennDepthToBitmap,
+                          "(Ljava/nio/ByteBuffer;IIIFFI[FFLandroid/graphics/Bitmap;)V"),
+};
+
+const JNINativeMethod PACK_OUTPUT_TO_BITMAP_METHODS[] = {
+        ENN_NATIVE_METHOD(ennPackOutputToBitmap,
+                          "(Ljava/nio/ByteBuffer;IIIIFFLandroid/graphics/Bitmap;)V"),
+};
+
+}  // namespace
+
+const EnnNativeMethods kEnnSelectTopKMethods = ENN_NATIVE_METHODS(SELECT_TOP_K_METHODS);
+const EnnNativeMethods kEnnDecodeYoloMethods = ENN_NATIVE_METHODS(DECODE_YOLO_METHODS);
+const EnnNativeMethods kEnnDecodePoseMethods = ENN_NATIVE_METHODS(DECODE_POSE_METHODS);
+const EnnNativeMethods kEnnSegmentToBitmapMethods = ENN_NATIVE_METHODS(SEGMENT_TO_BITMAP_METHODS);
+const EnnNativeMethods kEnnDepthToBitmapMethods = ENN_NATIVE_METHODS(DEPTH_TO_BITMAP_METHODS);
+const EnnNativeMethods kEnnPackOutputToBitmapMethods =
+        ENN_NATIVE_METHODS(PACK_OUTPUT_TO_BITMAP_METHODS);
@@ -0,0 +1,201 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "preprocess.h"
+
+#include <cmath>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+// Widens 16 channel values to 4 float vectors and normalizes them
+inline void normalize_u8x16(uint8x16_t value, float32x4_t offset, float32x4_t scale,
+                            float32x4_t out[4]) {
+    uint16x8_t low = vmovl_u8(vget_low_u8(value));
+    uint16x8_t high = vmovl_u8(vget_high_u8(value));
+
+    // Division rather than a reciprocal multiply keeps results identical to the scalar path
+    out[0] = vdivq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), offset), scale);
+    out[1] = vdivq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))), offset), scale);
+    out[2] = vdivq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), offset), scale);
+    out[3] = vdivq_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), offset), scale);
+}
+
+// Converts 16 pixels, returns the number of pixels left for the scalar tail
+uint32_t convert_row_neon(const uint8_t *src, uint32_t width, PreprocessLayer layer,
+                          float offset_value, float scale_value, float *dst, uint32_t plane) {
+    const float32x4_t offset = vdupq_n_f32(offset_value);
+    const float32x4_t scale = vdupq_n_f32(scale_value);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t rgba = vld4q_u8(src + x * 4);
+        float32x4_t r[4], g[4], b[4];
+
+        normalize_u8x16(rgba.val[0], offset, scale, r);
+        normalize_u8x16(rgba.val[1], offset, scale, g);
+        normalize_u8x16(rgba.val[2], offset, scale, b);
+
+        if (layer == PREPROCESS_LAYER_HWC) {
+            for (int i = 0; i < 4; i++) {
+                float32x4x3_t rgb = {{r[i], g[i], b[i]}};
+                vst3q_f32(dst + (x + i * 4) * 3, rgb);
+            }
+        } else {
+            for (int i = 0; i < 4; i++) {
+                vst1q_f32(dst + x + i * 4, r[i]);
+                vst1q_f32(dst + plane + x + i * 4, g[i]);
+                vst1q_f32(dst + 2 * plane + x + i * 4, b[i]);
+            }
+        }
+    }
+
+    return x;
+}
+
+// Quantizes 16 channel values the way Kotlin's toInt().toUByte() does:
+// truncate towards zero, saturate to int, then keep the low byte
+inline uint8x16_t quantize_u8x16(uint8x16_t value, float32x4_t offset, float32x4_t scale) {
+    float32x4_t normalized[4];
+    normalize_u8x16(value, offset, scale, normalized);
+
+    uint16x8_t low = vcombine_u16(
+            vmovn_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(normalized[0]))),
+            vmovn_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(normalized[1]))));
+    uint16x8_t high = vcombine_u16(
+            vmovn_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(normalized[2]))),
+            vmovn_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(normalized[3]))));
+
+    return vcombine_u8(vmovn_u16(low), vmovn_u16(high));
+}
+
+// Converts 16 pixels, returns the number of pixels left for the scalar tail
+uint32_t convert_row_u8_neon(const uint8_t *src, uint32_t width, PreprocessLayer layer,
+                             bool identity, float offset_value, float scale_value, uint8_t *dst,
+                             uint32_t plane) {
+    const float32x4_t offset = vdupq_n_f32(offset_value);
+    const float32x4_t scale = vdupq_n_f32(scale_value);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t rgba = vld4q_u8(src + x * 4);
+        uint8x16x3_t rgb;
+
+        if (identity) {
+            rgb.val[0] = rgba.val[0];
+            rgb.val[1] = rgba.val[1];
+            rgb.val[2] = rgba.val[2];
+        } else {
+            rgb.val[0] = quantize_u8x16(rgba.val[0], offset, scale);
+            rgb.val[1] = quantize_u8x16(rgba.val[1], offset, scale);
+            rgb.val[2] = quantize_u8x16(rgba.val[2], offset, scale);
+        }
+
+        if (layer == PREPROCESS_LAYER_HWC) {
+            vst3q_u8(dst + x * 3, rgb);
+        } else {
+            vst1q_u8(dst + x, rgb.val[0]);
+            vst1q_u8(dst + plane + x, rgb.val[1]);
+            vst1q_u8(dst + 2 * plane + x, rgb.val[2]);
+        }
+    }
+
+    return x;
+}
+
+#endif
+
+// Scalar equivalent of quantize_u8x16
+inline uint8_t quantize(uint8_t value, float offset, float scale) {
+    float normalized = (value - offset) / scale;
+
+    if (std::isnan(normalized)) {
+        return 0;
+    }
+    if (normalized >= static_cast<float>(INT32_MAX)) {
+        return static_cast<uint8_t>(INT32_MAX & 0xFF);
+    }
+    if (normalized <= static_cast<float>(INT32_MIN)) {
+        return 0;
+    }
+    return static_cast<uint8_t>(static_cast<uint32_t>(static_cast<int32_t>(normalized)));
+}
+
+}  // namespace
+
+void convert_rgba_row_to_float(const uint8_t *src, uint32_t width, PreprocessLayer layer,
+                               float offset, float scale, float *dst, uint32_t plane) {
+    // HWC interleaves channels, CHW writes them to separate planes
+    const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+    const uint32_t channel_offset = layer == PREPROCESS_LAYER_HWC ? 1 : plane;
+    uint32_t x = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    x = convert_row_neon(src, width, layer, offset, scale, dst, plane);
+#endif
+
+    for (; x < width; x++) {
+        const uint8_t *pixel = src + x * 4;
+        float *channel = dst + x * pixel_stride;
+
+        channel[0] = (pixel[0] - offset) / scale;
+        channel[channel_offset] = (pixel[1] - offset) / scale;
+        channel[2 * channel_offset] = (pixel[2] - offset) / scale;
+    }
+}
+
+void convert_rgba_row_to_uint8(const uint8_t *src, uint32_t width, PreprocessLayer layer,
+                               float offset, float scale, uint8_t *dst, uint32_t plane) {
+    const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+    const uint32_t channel_offset = layer == PREPROCESS_LAYER_HWC ? 1 : plane;
+    // Quantized models usually take the raw channels, which only needs a deinterleave
+    const bool identity = offset == 0.0f && scale == 1.0f;
+    uint32_t x = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    x = convert_row_u8_neon(src, width, layer, identity, offset, scale, dst, plane);
+#endif
+
+    for (; x < width; x++) {
+        const uint8_t *pixel = src + x * 4;
+        uint8_t *channel = dst + x * pixel_stride;
+
+        if (identity) {
+            channel[0] = pixel[0];
+            channel[channel_offset] = pixel[1];
+            channel[2 * channel_offset] = pixel[2];
+        } else {
+            channel[0] = quantize(pixel[0], offset, scale);
+            channel[channel_offset] = quantize(pixel[1], offset, scale);
+            channel[2 * channel_offset] = quantize(pixel[2], offset, scale);
+        }
+    }
+}
+
+void convert_rgba_to_float(const uint8_t *src, uint32_t src_stride, uint32_t width,
+                           uint32_t height, PreprocessLayer layer, float offset, float scale,
+                           float *dst) {
+    const uint32_t plane = width * height;
+    const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+
+    for (uint32_t y = 0; y < height; y++) {
+        convert_rgba_row_to_float(src + y * src_stride, width, layer, offset, scale,
+                                  dst + y * width * pixel_stride, plane);
+    }
+}
+
+void convert_rgba_to_uint8(const uint8_t *src, uint32_t src_stride, uint32_t width,
+                           uint32_t height, PreprocessLayer layer, float offset, float scale,
+                           uint8_t *dst) {
+    const uint32_t plane = width * height;
+    const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+
+    for (uint32_t y = 0; y < height; y++) {
+        convert_rgba_row_to_uint8(src + y * src_stride, width, layer, offset, scale,
+                                  dst + y * width * pixel_stride, plane);
+    }
+}
\ No newline at end of file
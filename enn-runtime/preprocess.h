@@ -0,0 +1,83 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+// Same order as data/LayerType.kt
+enum PreprocessLayer {
+    PREPROCESS_LAYER_HWC = 0,
+    PREPROCESS_LAYER_CHW = 1,
+};
+
+/**
+ * @brief Converts RGBA8888 pixels to normalized float32 RGB.
+ *
+ * Each channel is written as (value - offset) / scale, matching the Kotlin
+ * reference conversion. Alpha is dropped.
+ *
+ * @param src Pointer to the first pixel (R, G, B, A bytes per pixel).
+ * @param src_stride Distance between rows of src in bytes.
+ * @param width Number of pixels per row.
+ * @param height Number of rows.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param offset Value subtracted from each channel.
+ * @param scale Value each channel is divided by.
+ * @param dst Destination of width * height * 3 floats.
+ */
+void convert_rgba_to_float(const uint8_t *src, uint32_t src_stride, uint32_t width,
+                           uint32_t height, PreprocessLayer layer, float offset, float scale,
+                           float *dst);
+
+
+/**
+ * @brief Converts RGBA8888 pixels to quantized uint8 RGB.
+ *
+ * Each channel is written as the low byte of int((value - offset) / scale),
+ * matching the Kotlin reference conversion. With offset 0 and scale 1 the
+ * channels are copied as they are. Alpha is dropped.
+ *
+ * @param src Pointer to the first pixel (R, G, B, A bytes per pixel).
+ * @param src_stride Distance between rows of src in bytes.
+ * @param width Number of pixels per row.
+ * @param height Number of rows.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param offset Value subtracted from each channel.
+ * @param scale Value each channel is divided by.
+ * @param dst Destination of width * height * 3 bytes.
+ */
+void convert_rgba_to_uint8(const uint8_t *src, uint32_t src_stride, uint32_t width,
+                           uint32_t height, PreprocessLayer layer, float offset, float scale,
+                           uint8_t *dst);
+
+
+/**
+ * @brief Converts one row of RGBA8888 pixels like convert_rgba_to_float.
+ *
+ * @param src Pointer to the first pixel of the row.
+ * @param width Number of pixels to convert.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param offset Value subtracted from each channel.
+ * @param scale Value each channel is divided by.
+ * @param dst Position of the first pixel in the destination image.
+ * @param plane Number of pixels in one channel plane of the destination, used
+ *              by PREPROCESS_LAYER_CHW.
+ */
+void convert_rgba_row_to_float(const uint8_t *src, uint32_t width, PreprocessLayer layer,
+                               float offset, float scale, float *dst, uint32_t plane);
+
+
+/**
+ * @brief Converts one row of RGBA8888 pixels like convert_rgba_to_uint8.
+ *
+ * @param src Pointer to the first pixel of the row.
+ * @param width Number of pixels to convert.
+ * @param layer PREPROCESS_LAYER_HWC or PREPROCESS_LAYER_CHW.
+ * @param offset Value subtracted from each channel.
+ * @param scale Value each channel is divided by.
+ * @param dst Position of the first pixel in the destination image.
+ * @param plane Number of pixels in one channel plane of the destination, used
+ *              by PREPROCESS_LAYER_CHW.
+ */
+void convert_rgba_row_to_uint8(const uint8_t *src, uint32_t width, PreprocessLayer layer,
+                               float offset, float scale, uint8_t *dst, uint32_t plane);
\ No newline at end of file
@@ -0,0 +1,307 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks convert_rgba_row_to_float / convert_rgba_row_to_uint8 on fixed pixel rows.
+// Rows of 16 pixels or more take the NEON path on arm64, so each row is compared with
+// the same pixels converted one at a time, which always takes the scalar tail.
+//
+// Whole images converted by convert_rgba_to_float and convert_rgba_to_uint8 are
+// compared with ports of the Kotlin convertBitmapToFloatArray and
+// convertBitmapToUByteArray the kernels replaced, and single channel values with
+// quantized results worked out from Kotlin's toInt().toUByte().
+//
+//   preprocess_test
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "preprocess.h"
+#include "test_helpers.h"
+
+namespace {
+
+// Offset and scale pairs of the sample apps, followed by pairs that drive the
+// quantization out of range, negative and into int saturation
+struct Conversion {
+    float offset;
+    float scale;
+};
+
+const Conversion CONVERSIONS[] = {
+        {0.0f, 1.0f},
+        {127.5f, 127.5f},
+        {0.0f, 255.0f},
+        {128.0f, 1.0f},
+        {0.0f, 0.3f},
+        {255.0f, -0.5f},
+        {0.0f, 1e-8f},
+        {64.0f, -1e-8f},
+};
+
+// Widths around the 16 pixel NEON blocks, and a camera-sized row
+const uint32_t WIDTHS[] = {0, 1, 7, 15, 16, 17, 31, 32, 33, 47, 64, 299, 640};
+
+// Fixed RGBA row with blue 0 and 255 at the edges of every 16 pixel block
+std::vector<uint8_t> make_row(uint32_t width) {
+    std::vector<uint8_t> row(width * 4);
+
+    for (uint32_t x = 0; x < width; x++) {
+        row[x * 4] = static_cast<uint8_t>(x * 37);
+        row[x * 4 + 1] = static_cast<uint8_t>(255 - x * 91);
+        row[x * 4 + 2] = x % 16 == 15 ? 255 : x % 16 == 0 ? 0 : static_cast<uint8_t>(x * 13 + 7);
+        row[x * 4 + 3] = static_cast<uint8_t>(x);
+    }
+
+    return row;
+}
+
+// Converts a row with a single call and pixel by pixel, and compares the results bit
+// for bit. The destination is a CHW plane of 2 rows so that plane offsets are tested.
+template <typename T, typename ConvertRow>
+void check_row_matches_scalar(const char *type, ConvertRow convert_row) {
+    for (uint32_t width : WIDTHS) {
+        const std::vector<uint8_t> row = make_row(width);
+        const uint32_t plane = width * 2;
+
+        for (PreprocessLayer layer : {PREPROCESS_LAYER_HWC, PREPROCESS_LAYER_CHW}) {
+            const uint32_t pixel_stride = layer == PREPROCESS_LAYER_HWC ? 3 : 1;
+
+            for (const Conversion &conversion : CONVERSIONS) {
+                std::vector<T> row_output(plane * 3), pixel_output(plane * 3);
+
+                convert_row(row.data(), width, layer, conversion.offset, conversion.scale,
+                            row_output.data(), plane);
+                for (uint32_t x = 0; x < width; x++) {
+                    convert_row(row.data() + x * 4, 1, layer, conversion.offset,
+                                conversion.scale, pixel_output.data() + x * pixel_stride,
+                                plane);
+                }
+
+                // Empty rows have no data to compare, and memcmp must not be
+                // passed their null pointers
+                EXPECT_TRUE(row_output.empty() ||
+                                    !memcmp(row_output.data(), pixel_output.data(),
+                                            row_output.size() * sizeof(T)),
+                            "%s row of %u pixels, layer %d, offset %g, scale %g", type,
+                            width, layer, conversion.offset, conversion.scale);
+            }
+        }
+    }
+}
+
+// Bitmap.getPixels() colors of a width x height image, 0xAARRGGBB
+std::vector<uint32_t> make_colors(uint32_t width, uint32_t height) {
+    std::vector<uint32_t> colors(width * height);
+
+    for (uint32_t i = 0; i < colors.size(); i++) {
+        colors[i] = 0xFF000000u | (i * 2654435761u & 0x00FFFFFFu);
+    }
+    colors[0] = 0xFF000000u;
+    colors[colors.size() - 1] = 0xFFFFFFFFu;
+
+    return colors;
+}
+
+// The ARGB_8888 pixels AndroidBitmap_lockPixels returns for colors: R, G, B, A bytes
+// with padding at the end of every row
+std::vector<uint8_t> lock_pixels(const std::vector<uint32_t> &colors, uint32_t width,
+                                 uint32_t height, uint32_t stride) {
+    std::vector<uint8_t> pixels(stride * height, 0xCD);
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t color = colors[y * width + x];
+            uint8_t *pixel = &pixels[y * stride + x * 4];
+
+            pixel[0] = static_cast<uint8_t>(color >> 16);
+            pixel[1] = static_cast<uint8_t>(color >> 8);
+            pixel[2] = static_cast<uint8_t>(color);
+            pixel[3] = static_cast<uint8_t>(color >> 24);
+        }
+    }
+
+    return pixels;
+}
+
+// ModelExecutor.convertBitmapToFloatArray as the apps shipped it
+std::vector<float> kotlin_float_array(const std::vector<uint32_t> &colors, uint32_t total_pixels,
+                                      PreprocessLayer layer, float conversion_offset,
+                                      float conversion_scale) {
+    std::vector<float> float_array(total_pixels * 3);
+    uint32_t offset[3];
+    uint32_t stride;
+
+    if (layer == PREPROCESS_LAYER_CHW) {
+        offset[0] = 0, offset[1] = total_pixels, offset[2] = 2 * total_pixels;
+        stride = 1;
+    } else {
+        offset[0] = 0, offset[1] = 1, offset[2] = 2;
+        stride = 3;
+    }
+
+    for (uint32_t i = 0; i < total_pixels; i++) {
+        const int32_t color = static_cast<int32_t>(colors[i]);
+        float_array[i * stride + offset[0]] =
+                (((color >> 16) & 0xFF) - conversion_offset) / conversion_scale;
+        float_array[i * stride + offset[1]] =
+                (((color >> 8) & 0xFF) - conversion_offset) / conversion_scale;
+        float_array[i * stride + offset[2]] =
+                (((color >> 0) & 0xFF) - conversion_offset) / conversion_scale;
+    }
+
+    return float_array;
+}
+
+// Input sizes and conversions of the sample apps, and an image smaller than a NEON block
+struct FloatInput {
+    uint32_t width;
+    uint32_t height;
+    float offset;
+    float scale;
+};
+
+const FloatInput FLOAT_INPUTS[] = {
+        {256, 256, 127.5f, 127.5f},
+        {257, 257, 127.5f, 127.5f},
+        {640, 640, 127.5f, 127.5f},
+        {600, 400, 0.0f, 256.0f},
+        {299, 299, 0.0f, 1.0f},
+        {5, 3, 127.5f, 127.5f},
+};
+
+void check_float_matches_kotlin() {
+    for (const FloatInput &input : FLOAT_INPUTS) {
+        const std::vector<uint32_t> colors = make_colors(input.width, input.height);
+        const uint32_t stride = input.width * 4 + 32;
+        const std::vector<uint8_t> pixels = lock_pixels(colors, input.width, input.height,
+                                                        stride);
+
+        for (PreprocessLayer layer : {PREPROCESS_LAYER_HWC, PREPROCESS_LAYER_CHW}) {
+            const std::vector<float> expected = kotlin_float_array(
+                    colors, input.width * input.height, layer, input.offset, input.scale);
+            std::vector<float> output(expected.size());
+
+            convert_rgba_to_float(pixels.data(), stride, input.width, input.height, layer,
+                                  input.offset, input.scale, output.data());
+
+            EXPECT_TRUE(!memcmp(output.data(), expected.data(), output.size() * sizeof(float)),
+                        "float %ux%u, layer %d, offset %g, scale %g", input.width,
+                        input.height, layer, input.offset, input.scale);
+        }
+    }
+}
+
+// Float.toInt() of Kotlin: truncates towards zero, saturates and maps NaN to 0
+int32_t kotlin_to_int(float value) {
+    if (std::isnan(value)) {
+        return 0;
+    }
+    if (value >= 2147483647.0f) {
+        return INT32_MAX;
+    }
+    if (value <= -2147483648.0f) {
+        return INT32_MIN;
+    }
+    return static_cast<int32_t>(value);
+}
+
+// ModelExecutor.convertBitmapToUByteArray as the apps shipped it
+std::vector<uint8_t> kotlin_ubyte_array(const std::vector<uint32_t> &colors,
+                                        uint32_t total_pixels, PreprocessLayer layer,
+                                        float conversion_offset, float conversion_scale) {
+    std::vector<uint8_t> ubyte_array(total_pixels * 3);
+    const uint32_t stride = layer == PREPROCESS_LAYER_CHW ? 1 : 3;
+    const uint32_t offset = layer == PREPROCESS_LAYER_CHW ? total_pixels : 1;
+
+    for (uint32_t i = 0; i < total_pixels; i++) {
+        const int32_t color = static_cast<int32_t>(colors[i]);
+
+        for (uint32_t c = 0; c < 3; c++) {
+            const int32_t value = (color >> (16 - 8 * c)) & 0xFF;
+            // toUByte() keeps the low byte
+            ubyte_array[i * stride + c * offset] = static_cast<uint8_t>(
+                    kotlin_to_int((value - conversion_offset) / conversion_scale) & 0xFF);
+        }
+    }
+
+    return ubyte_array;
+}
+
+// A channel value, a conversion and the byte Kotlin's
+// ((value - offset) / scale).toInt().toUByte() gives for it
+struct Quantized {
+    uint8_t value;
+    float offset;
+    float scale;
+    uint8_t expected;
+};
+
+const Quantized QUANTIZED[] = {
+        {200, 0.0f, 1.0f, 200},
+        {3, 0.0f, 2.0f, 1},            // 1.5 truncates to 1
+        {0, 1.0f, 2.0f, 0},            // -0.5 truncates towards zero
+        {0, 3.0f, 2.0f, 255},          // -1.5 truncates to -1, whose low byte is 255
+        {10, 128.0f, 1.0f, 138},       // -118
+        {255, 0.0f, 0.3f, 81},         // 849.99994 in float, truncates to 849
+        {0, 255.0f, -0.5f, 254},       // 510
+        {1, 0.0f, 1e-8f, 0},           // 100000000 = 0x05F5E100
+        {255, 0.0f, 1e-8f, 255},       // saturates to 0x7FFFFFFF
+        {10, 128.0f, 1e-8f, 0},        // saturates to 0x80000000
+        {255, 127.5f, 127.5f, 1},
+        {0, 127.5f, 127.5f, 255},      // -1
+};
+
+void check_uint8_matches_kotlin() {
+    for (const Quantized &quantized : QUANTIZED) {
+        // 17 pixels, so that the value is converted by a NEON block and by the scalar tail
+        std::vector<uint8_t> row(17 * 4, quantized.value);
+        std::vector<uint8_t> output(17 * 3);
+
+        convert_rgba_row_to_uint8(row.data(), 17, PREPROCESS_LAYER_HWC, quantized.offset,
+                                  quantized.scale, output.data(), 17);
+
+        for (uint32_t i = 0; i < output.size(); i++) {
+            EXPECT_TRUE(output[i] == quantized.expected,
+                        "value %u, offset %g, scale %g: channel %u is %u, expected %u",
+                        quantized.value, quantized.offset, quantized.scale, i, output[i],
+                        quantized.expected);
+        }
+    }
+
+    // Inception v4 of image-classification and perf-compare, which takes the raw
+    // channels, and a small image for every conversion of CONVERSIONS
+    std::vector<FloatInput> inputs = {{299, 299, 0.0f, 1.0f}};
+    for (const Conversion &conversion : CONVERSIONS) {
+        inputs.push_back({37, 5, conversion.offset, conversion.scale});
+    }
+
+    for (const FloatInput &input : inputs) {
+        const std::vector<uint32_t> colors = make_colors(input.width, input.height);
+        const uint32_t stride = input.width * 4 + 32;
+        const std::vector<uint8_t> pixels = lock_pixels(colors, input.width, input.height,
+                                                        stride);
+
+        for (PreprocessLayer layer : {PREPROCESS_LAYER_HWC, PREPROCESS_LAYER_CHW}) {
+            const std::vector<uint8_t> expected = kotlin_ubyte_array(
+                    colors, input.width * input.height, layer, input.offset, input.scale);
+            std::vector<uint8_t> output(expected.size());
+
+            convert_rgba_to_uint8(pixels.data(), stride, input.width, input.height, layer,
+                                  input.offset, input.scale, output.data());
+
+            EXPECT_TRUE(output == expected, "uint8 %ux%u, layer %d, offset %g, scale %g",
+                        input.width, input.height, layer, input.offset, input.scale);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    check_row_matches_scalar<float>("float", convert_rgba_row_to_float);
+    check_row_matches_scalar<uint8_t>("uint8", convert_rgba_row_to_uint8);
+    check_float_matches_kotlin();
+    check_uint8_matches_kotlin();
+
+    return TestResult("preprocess_test");
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "segment_mask.h"
+
+namespace {
+
+// Rounded a * b / 255, as Skia premultiplies colors
+inline uint32_t multiply_alpha(uint32_t component, uint32_t alpha) {
+    const uint32_t product = component * alpha + 128;
+    return (product + (product >> 8)) >> 8;
+}
+
+inline uint32_t argmax(const float *scores, uint32_t channels) {
+    float best = 0.0f;
+    uint32_t best_index = 0;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        if (scores[c] > best) {
+            best = scores[c];
+            best_index = c;
+        }
+    }
+    return best_index;
+}
+
+}  // namespace
+
+void premultiply_palette(const int32_t *colors, uint32_t count, uint32_t *palette) {
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t color = static_cast<uint32_t>(colors[i]);
+        const uint32_t a = color >> 24;
+        const uint32_t r = multiply_alpha((color >> 16) & 0xFF, a);
+        const uint32_t g = multiply_alpha((color >> 8) & 0xFF, a);
+        const uint32_t b = multiply_alpha(color & 0xFF, a);
+
+        // RGBA_8888 is stored as R, G, B, A bytes
+        palette[i] = r | (g << 8) | (b << 16) | (a << 24);
+    }
+}
+
+void argmax_to_palette(const float *scores, uint32_t width, uint32_t height, uint32_t channels,
+                       const uint32_t *palette, uint8_t *dst, uint32_t dst_stride) {
+    for (uint32_t y = 0; y < height; y++) {
+        const float *row = scores + static_cast<uint64_t>(y) * width * channels;
+        auto *out = reinterpret_cast<uint32_t *>(dst + static_cast<uint64_t>(y) * dst_stride);
+
+        for (uint32_t x = 0; x < width; x++) {
+            out[x] = palette[argmax(row + x * channels, channels)];
+        }
+    }
+}
+
+void argmax_to_palette(const uint8_t *scores, uint32_t width, uint32_t height, uint32_t channels,
+                       float offset, float scale, const uint32_t *palette, uint8_t *dst,
+                       uint32_t dst_stride) {
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = scores + static_cast<uint64_t>(y) * width * channels;
+        auto *out = reinterpret_cast<uint32_t *>(dst + static_cast<uint64_t>(y) * dst_stride);
+
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t *pixel = row + x * channels;
+            float best = 0.0f;
+            uint32_t best_index = 0;
+
+            for (uint32_t c = 0; c < channels; c++) {
+                const float value = (pixel[c] - offset) / scale;
+                if (value > best) {
+                    best = value;
+                    best_index = c;
+                }
+            }
+            out[x] = palette[best_index];
+        }
+    }
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Converts ARGB color ints to premultiplied RGBA_8888 pixels.
+ *
+ * @param colors Colors as packed by android.graphics.Color.
+ * @param count Number of colors.
+ * @param palette Receives count pixels ready to be stored in a Bitmap.
+ */
+void premultiply_palette(const int32_t *colors, uint32_t count, uint32_t *palette);
+
+/**
+ * @brief Writes the palette color of the best class of each pixel.
+ *
+ * scores holds channels values per pixel (HWC). A class is selected only
+ * when its score is above zero and above every earlier class, so pixels
+ * without any positive score map to palette[0].
+ *
+ * @param scores Pointer to width * height * channels scores.
+ * @param width Number of pixels per row.
+ * @param height Number of rows.
+ * @param channels Number of classes, at most palette_size.
+ * @param palette Premultiplied pixel per class.
+ * @param dst Pointer to the first row of the mask.
+ * @param dst_stride Distance between rows of dst in bytes.
+ */
+void argmax_to_palette(const float *scores, uint32_t width, uint32_t height, uint32_t channels,
+                       const uint32_t *palette, uint8_t *dst, uint32_t dst_stride);
+
+/**
+ * @brief uint8 variant of argmax_to_palette.
+ *
+ * Scores are dequantized as (value - offset) / scale before the comparison.
+ */
+void argmax_to_palette(const uint8_t *scores, uint32_t width, uint32_t height, uint32_t channels,
+                       float offset, float scale, const uint32_t *palette, uint8_t *dst,
+                       uint32_t dst_stride);
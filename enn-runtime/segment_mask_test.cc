@@ -0,0 +1,193 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks argmax_to_palette against a scalar reference of the Kotlin postProcess it
+// replaced: the first class whose score is above zero and above every earlier class,
+// or class 0. The sizes cover empty masks, single pixels and rows, and the 257x257x21
+// output of DeepLabV3; premultiply_palette is checked against exact rounding.
+//
+//   segment_mask_test
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "segment_mask.h"
+#include "test_helpers.h"
+
+namespace {
+
+// Value of the bytes after each row, which must not be written
+constexpr uint8_t kCanary = 0xA5;
+constexpr uint32_t kRowPadding = 12;
+
+struct Shape {
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+};
+
+const Shape SHAPES[] = {
+        {0, 0, 21}, {0, 3, 21}, {3, 0, 21},
+        {1, 1, 1}, {1, 1, 21}, {5, 1, 2}, {9, 3, 3}, {17, 2, 21},
+        {257, 257, 21},
+};
+
+// Scores around zero, ties and values that never compare greater, repeated over
+// the output
+const float VALUES[] = {
+        0.0f, 0.5f, -0.5f, 0.5f, 1.0f, 3.0f, -3.0f, 2.99f, 1e-30f, -1e-30f, 3.0f,
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN(),
+};
+
+struct Dequantization {
+    float offset;
+    float scale;
+};
+
+// DeepLabV3 uint8, a zero point in the middle, and a negative scale that reverses
+// the order of the values
+const Dequantization DEQUANTIZATIONS[] = {{0.0f, 1.0f}, {128.0f, 0.5f}, {200.0f, -2.0f}};
+
+template<typename T>
+uint32_t reference_class(const T *scores, uint32_t channels, float offset, float scale) {
+    float best = 0.0f;
+    uint32_t best_index = 0;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        const float value = (static_cast<float>(scores[c]) - offset) / scale;
+        if (value > best) {
+            best = value;
+            best_index = c;
+        }
+    }
+    return best_index;
+}
+
+// One distinct pixel per class, so that a wrong class shows in the output
+std::vector<uint32_t> make_palette(uint32_t channels) {
+    std::vector<uint32_t> palette(channels);
+    for (uint32_t c = 0; c < channels; c++) {
+        palette[c] = 0x01000000u * (c + 1) + 0x00010203u * c;
+    }
+    return palette;
+}
+
+template<typename T>
+std::vector<uint8_t> reference_mask(const std::vector<T> &scores, const Shape &shape,
+                                    float offset, float scale,
+                                    const std::vector<uint32_t> &palette, uint32_t stride) {
+    std::vector<uint8_t> expected(stride * shape.height, kCanary);
+
+    for (uint32_t y = 0; y < shape.height; y++) {
+        for (uint32_t x = 0; x < shape.width; x++) {
+            const uint32_t pixel = y * shape.width + x;
+            const uint32_t color = palette[reference_class(
+                    &scores[pixel * shape.channels], shape.channels, offset, scale)];
+            uint8_t *out = &expected[y * stride + x * 4];
+
+            for (uint32_t byte = 0; byte < 4; byte++) {
+                out[byte] = static_cast<uint8_t>(color >> (8 * byte));
+            }
+        }
+    }
+    return expected;
+}
+
+uint32_t count_mismatches(const std::vector<uint8_t> &output,
+                          const std::vector<uint8_t> &expected) {
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < output.size(); i++) {
+        mismatches += output[i] != expected[i];
+    }
+    return mismatches;
+}
+
+void check_float_mask(const Shape &shape) {
+    const uint32_t stride = shape.width * 4 + kRowPadding;
+    const uint32_t value_count = sizeof(VALUES) / sizeof(VALUES[0]);
+    const std::vector<uint32_t> palette = make_palette(shape.channels);
+
+    std::vector<float> scores(shape.width * shape.height * shape.channels);
+    for (uint32_t i = 0; i < scores.size(); i++) {
+        scores[i] = VALUES[(i * 5 + i / 7) % value_count];
+    }
+
+    const std::vector<uint8_t> expected =
+            reference_mask(scores, shape, 0.0f, 1.0f, palette, stride);
+    std::vector<uint8_t> output(stride * shape.height, kCanary);
+    argmax_to_palette(scores.data(), shape.width, shape.height, shape.channels, palette.data(),
+                      output.data(), stride);
+
+    const uint32_t mismatches = count_mismatches(output, expected);
+    EXPECT_TRUE(mismatches == 0, "float %ux%ux%u: %u bytes differ", shape.width, shape.height,
+                shape.channels, mismatches);
+}
+
+void check_uint8_mask(const Shape &shape, const Dequantization &dequantization) {
+    const uint32_t stride = shape.width * 4 + kRowPadding;
+    const std::vector<uint32_t> palette = make_palette(shape.channels);
+
+    std::vector<uint8_t> scores(shape.width * shape.height * shape.channels);
+    for (uint32_t i = 0; i < scores.size(); i++) {
+        // Few distinct values, so that ties are common
+        scores[i] = static_cast<uint8_t>((i * 37 + i / 5) % 7 * 42);
+    }
+
+    const std::vector<uint8_t> expected = reference_mask(
+            scores, shape, dequantization.offset, dequantization.scale, palette, stride);
+    std::vector<uint8_t> output(stride * shape.height, kCanary);
+    argmax_to_palette(scores.data(), shape.width, shape.height, shape.channels,
+                      dequantization.offset, dequantization.scale, palette.data(),
+                      output.data(), stride);
+
+    const uint32_t mismatches = count_mismatches(output, expected);
+    EXPECT_TRUE(mismatches == 0, "uint8 %ux%ux%u, offset %g, scale %g: %u bytes differ",
+                shape.width, shape.height, shape.channels, dequantization.offset,
+                dequantization.scale, mismatches);
+}
+
+// Every component and alpha, against round(component * alpha / 255)
+void check_premultiply() {
+    std::vector<int32_t> colors;
+    for (uint32_t alpha = 0; alpha < 256; alpha++) {
+        for (uint32_t component = 0; component < 256; component++) {
+            const uint32_t color =
+                    alpha << 24 | component << 16 | (255 - component) << 8 | (component ^ 0x5A);
+            colors.push_back(static_cast<int32_t>(color));
+        }
+    }
+
+    std::vector<uint32_t> palette(colors.size());
+    premultiply_palette(colors.data(), static_cast<uint32_t>(colors.size()), palette.data());
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < colors.size(); i++) {
+        const uint32_t color = static_cast<uint32_t>(colors[i]);
+        const uint32_t alpha = color >> 24;
+        uint32_t expected = alpha << 24;
+
+        // ARGB components, stored as R, G, B bytes
+        for (uint32_t byte = 0; byte < 3; byte++) {
+            const uint32_t component = (color >> (16 - 8 * byte)) & 0xFF;
+            const auto rounded = static_cast<uint32_t>(std::lround(component * alpha / 255.0));
+            expected |= rounded << (8 * byte);
+        }
+        mismatches += palette[i] != expected;
+    }
+    EXPECT_TRUE(mismatches == 0, "%u premultiplied colors differ", mismatches);
+}
+
+}  // namespace
+
+int main() {
+    for (const Shape &shape : SHAPES) {
+        check_float_mask(shape);
+        for (const Dequantization &dequantization : DEQUANTIZATIONS) {
+            check_uint8_mask(shape, dequantization);
+        }
+    }
+    check_premultiply();
+
+    return TestResult("segment_mask_test");
+}
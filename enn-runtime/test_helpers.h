@@ -0,0 +1,34 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdio>
+
+// Assertions of the host tests, which build without a test framework. A failed check
+// is reported and counted rather than aborting, so that one run lists every mismatch.
+
+inline int &TestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define EXPECT_TRUE(condition, ...)                                         \
+    do {                                                                    \
+        if (!(condition)) {                                                 \
+            fprintf(stderr, "%s:%d: %s: ", __FILE__, __LINE__, #condition); \
+            fprintf(stderr, __VA_ARGS__);                                   \
+            fputc('\n', stderr);                                            \
+            TestFailures()++;                                               \
+        }                                                                   \
+    } while (0)
+
+// Exit code of a test, 0 if every check passed
+inline int TestResult(const char *name) {
+    if (TestFailures()) {
+        printf("%s: %d checks failed\n", name, TestFailures());
+        return 1;
+    }
+
+    printf("%s: passed\n", name);
+    return 0;
+}
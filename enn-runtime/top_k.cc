@@ -0,0 +1,98 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "top_k.h"
+
+#include <algorithm>
+
+namespace {
+
+// Higher scores first, lower indices first among equal scores
+inline bool ranks_before(const ScoredClass &a, const ScoredClass &b) {
+    return a.score > b.score || (a.score == b.score && a.index < b.index);
+}
+
+inline float lookup_score(uint32_t value, float offset, float scale, const float *dequantize) {
+    const float position = (value - offset) / scale;
+    if (!(position > 0.0f)) {
+        return dequantize[0];
+    }
+    return dequantize[position >= 255.0f ? 255 : static_cast<uint32_t>(position)];
+}
+
+}  // namespace
+
+void select_top_k(const uint8_t *output, uint32_t count, uint32_t k, float threshold,
+                  float offset, float scale, const float *dequantize,
+                  std::vector<ScoredClass> *result) {
+    result->clear();
+    if (k == 0) {
+        return;
+    }
+
+    uint32_t histogram[256] = {};
+    for (uint32_t i = 0; i < count; i++) {
+        histogram[output[i]]++;
+    }
+
+    float bin_score[256];
+    uint32_t bins[256];
+    for (uint32_t b = 0; b < 256; b++) {
+        bin_score[b] = lookup_score(b, offset, scale, dequantize);
+        bins[b] = b;
+    }
+    std::sort(bins, bins + 256, [&bin_score](uint32_t a, uint32_t b) {
+        return bin_score[a] > bin_score[b];
+    });
+
+    // Lowest score that still reaches k classes, every class above it survives
+    float cutoff = threshold;
+    uint32_t covered = 0;
+    for (uint32_t b : bins) {
+        if (bin_score[b] < threshold) {
+            break;
+        }
+        if (histogram[b] == 0) {
+            continue;
+        }
+        covered += histogram[b];
+        cutoff = bin_score[b];
+        if (covered >= k) {
+            break;
+        }
+    }
+    if (covered == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const float score = bin_score[output[i]];
+        if (score >= cutoff) {
+            result->push_back({i, score});
+        }
+    }
+
+    // Classes sharing the cutoff score may exceed k
+    std::stable_sort(result->begin(), result->end(), ranks_before);
+    if (result->size() > k) {
+        result->resize(k);
+    }
+}
+
+void select_top_k(const float *output, uint32_t count, uint32_t k, float threshold, float offset,
+                  float scale, std::vector<ScoredClass> *result) {
+    result->clear();
+    if (k == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const float score = (output[i] - offset) / scale;
+        if (score >= threshold) {
+            result->push_back({i, score});
+        }
+    }
+
+    const size_t kept = std::min<size_t>(k, result->size());
+    std::partial_sort(result->begin(), result->begin() + kept, result->end(), ranks_before);
+    result->resize(kept);
+}
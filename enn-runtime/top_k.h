@@ -0,0 +1,42 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct ScoredClass {
+    uint32_t index;
+    float score;
+};
+
+/**
+ * @brief Selects the best scoring classes of a uint8 output.
+ *
+ * A class scores dequantize[int((value - offset) / scale)], with the table
+ * index clamped to 0..255. Only the classes scoring at least threshold are
+ * kept. They are ordered by descending score, then by ascending index. The
+ * cutoff is found with a 256-bin histogram, so scores are only looked up
+ * per bin and for the survivors.
+ *
+ * @param output Pointer to count raw values.
+ * @param count Number of classes.
+ * @param k Maximum number of classes to return.
+ * @param threshold Minimum score.
+ * @param offset Value subtracted before the table lookup.
+ * @param scale Value divided by before the table lookup.
+ * @param dequantize Table of 256 scores.
+ * @param result Receives at most k classes (cleared first).
+ */
+void select_top_k(const uint8_t *output, uint32_t count, uint32_t k, float threshold,
+                  float offset, float scale, const float *dequantize,
+                  std::vector<ScoredClass> *result);
+
+/**
+ * @brief Selects the best scoring classes of a float output.
+ *
+ * A class scores (value - offset) / scale. Ordering and threshold are the
+ * same as for the uint8 variant; only the survivors are partially sorted.
+ */
+void select_top_k(const float *output, uint32_t count, uint32_t k, float threshold, float offset,
+                  float scale, std::vector<ScoredClass> *result);
@@ -0,0 +1,149 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks select_top_k against a scalar reference of the Kotlin postProcess it replaced:
+// every class is scored, those below the threshold are dropped and the rest are stable
+// sorted by descending score, then the first k are kept. The uint8 table index is
+// clamped to 0..255, where Kotlin would have thrown. The outputs cover ties within and
+// across histogram bins, tables that are not monotonic, and the 1001 classes of the
+// image-classification models.
+//
+//   top_k_test
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "test_helpers.h"
+#include "top_k.h"
+
+namespace {
+
+const uint32_t COUNTS[] = {0, 1, 5, 37, 1001};
+const uint32_t KS[] = {0, 1, 3, 5, 37, 2000};
+const float THRESHOLDS[] = {-std::numeric_limits<float>::infinity(), 0.0f, 0.5f, 2.0f};
+
+struct Dequantization {
+    float offset;
+    float scale;
+};
+
+// Identity, a zero point with a scale that skips entries, and a negative scale whose
+// indices all clamp to 0
+const Dequantization DEQUANTIZATIONS[] = {{0.0f, 1.0f}, {64.0f, 0.5f}, {0.0f, -1.0f}};
+
+// Scores around the thresholds with repeats, NaN and infinities
+const float FLOAT_SCORES[] = {
+        0.1f, 0.9f, 0.5f, 0.9f, -0.25f, 0.49999997f, 1.0f, 0.0f, 0.9f, 0.75f,
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(), 0.5f, 0.3f,
+};
+
+std::vector<ScoredClass> reference_top_k(const std::vector<float> &scores, uint32_t k,
+                                         float threshold) {
+    std::vector<ScoredClass> result;
+
+    for (uint32_t i = 0; i < scores.size(); i++) {
+        if (scores[i] >= threshold) {
+            result.push_back({i, scores[i]});
+        }
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const ScoredClass &a, const ScoredClass &b) { return a.score > b.score; });
+    if (result.size() > k) {
+        result.resize(k);
+    }
+    return result;
+}
+
+bool same_classes(const std::vector<ScoredClass> &a, const std::vector<ScoredClass> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.size(); i++) {
+        if (a[i].index != b[i].index || a[i].score != b[i].score) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ascending table, and one that rises and falls with plateaus, so that bins far
+// apart share a score
+std::vector<std::vector<float>> make_tables() {
+    std::vector<float> ascending(256);
+    std::vector<float> folded(256);
+
+    for (uint32_t i = 0; i < 256; i++) {
+        ascending[i] = i / 255.0f;
+        folded[i] = static_cast<float>(i < 128 ? i / 16 : (255 - i) / 16) / 8.0f;
+    }
+    return {ascending, folded};
+}
+
+void check_uint8(uint32_t count, const std::vector<float> &table,
+                 const Dequantization &dequantization) {
+    std::vector<uint8_t> output(count);
+    std::vector<float> scores(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        // Few distinct values, so that bins hold several classes
+        output[i] = static_cast<uint8_t>((i * 97 + i / 3) % 13 * 19);
+
+        const float position = (output[i] - dequantization.offset) / dequantization.scale;
+        const int32_t index = position >= 255.0f ? 255 : static_cast<int32_t>(position);
+        scores[i] = table[std::max(index, 0)];
+    }
+
+    for (uint32_t k : KS) {
+        for (float threshold : THRESHOLDS) {
+            std::vector<ScoredClass> result = {{7, 7.0f}};
+            select_top_k(output.data(), count, k, threshold, dequantization.offset,
+                         dequantization.scale, table.data(), &result);
+
+            EXPECT_TRUE(same_classes(result, reference_top_k(scores, k, threshold)),
+                        "uint8, %u classes, k %u, threshold %g, offset %g, scale %g", count, k,
+                        threshold, dequantization.offset, dequantization.scale);
+        }
+    }
+}
+
+void check_float(uint32_t count, const Dequantization &dequantization) {
+    const uint32_t value_count = sizeof(FLOAT_SCORES) / sizeof(FLOAT_SCORES[0]);
+    std::vector<float> output(count);
+    std::vector<float> scores(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        scores[i] = FLOAT_SCORES[(i * 7 + i / 4) % value_count];
+        output[i] = scores[i] * dequantization.scale + dequantization.offset;
+        scores[i] = (output[i] - dequantization.offset) / dequantization.scale;
+    }
+
+    for (uint32_t k : KS) {
+        for (float threshold : THRESHOLDS) {
+            std::vector<ScoredClass> result = {{7, 7.0f}};
+            select_top_k(output.data(), count, k, threshold, dequantization.offset,
+                         dequantization.scale, &result);
+
+            EXPECT_TRUE(same_classes(result, reference_top_k(scores, k, threshold)),
+                        "float, %u classes, k %u, threshold %g, offset %g, scale %g", count, k,
+                        threshold, dequantization.offset, dequantization.scale);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    const std::vector<std::vector<float>> tables = make_tables();
+
+    for (uint32_t count : COUNTS) {
+        for (const Dequantization &dequantization : DEQUANTIZATIONS) {
+            for (const std::vector<float> &table : tables) {
+                check_uint8(count, table, dequantization);
+            }
+            check_float(count, dequantization);
+        }
+    }
+
+    return TestResult("top_k_test");
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#include "yolo_decoder.h"
+
+#include <cstddef>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kBoxValues = 5;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+// Four objectness values are gathered per step so that rows below threshold,
+// which are almost all of them, are rejected without touching the class scores
+inline uint32_t objectness_mask(const float *row, uint32_t row_size, float32x4_t threshold) {
+    float32x4_t objectness = vdupq_n_f32(0.0f);
+    objectness = vld1q_lane_f32(row + 4, objectness, 0);
+    objectness = vld1q_lane_f32(row + row_size + 4, objectness, 1);
+    objectness = vld1q_lane_f32(row + 2 * row_size + 4, objectness, 2);
+    objectness = vld1q_lane_f32(row + 3 * row_size + 4, objectness, 3);
+
+    const uint32x4_t pass = vcgeq_f32(objectness, threshold);
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(pass, bits));
+}
+
+inline float max_score(const float *scores, uint32_t count, uint32_t *index) {
+    uint32_t i = 0;
+    float best;
+
+    if (count >= 4) {
+        float32x4_t best_vector = vld1q_f32(scores);
+        for (i = 4; i + 4 <= count; i += 4) {
+            best_vector = vmaxq_f32(best_vector, vld1q_f32(scores + i));
+        }
+        best = vmaxvq_f32(best_vector);
+    } else {
+        best = scores[0];
+        i = 1;
+    }
+    for (; i < count; i++) {
+        best = scores[i] > best ? scores[i] : best;
+    }
+
+    // First class holding the maximum, as Kotlin's maxByOrNull picks
+    for (i = 0; i + 1 < count && scores[i] != best; i++) {}
+    *index = i;
+    return scores[i];
+}
+
+#else
+
+inline float max_score(const float *scores, uint32_t count, uint32_t *index) {
+    uint32_t best_index = 0;
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (scores[i] > scores[best_index]) {
+            best_index = i;
+        }
+    }
+
+    *index = best_index;
+    return scores[best_index];
+}
+
+#endif
+
+inline float max_score(const uint8_t *scores, uint32_t count, uint32_t *index) {
+    uint32_t best_index = 0;
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (scores[i] > scores[best_index]) {
+            best_index = i;
+        }
+    }
+
+    *index = best_index;
+    return scores[best_index];
+}
+
+template<typename T>
+inline void decode_row(const T *row, uint32_t row_size, float threshold,
+                       std::vector<YoloDetection> *detections) {
+    if (row[4] < threshold) {
+        return;
+    }
+
+    uint32_t class_id;
+    const float score = max_score(row + kBoxValues, row_size - kBoxValues, &class_id);
+    if (score < threshold) {
+        return;
+    }
+
+    const float cx = row[0], cy = row[1];
+    const float half_w = row[2] / 2.0f, half_h = row[3] / 2.0f;
+    detections->push_back({cx - half_w, cy - half_h, cx + half_w, cy + half_h, score,
+                           static_cast<int32_t>(class_id)});
+}
+
+}  // namespace
+
+void decode_yolo_output(const float *output, uint32_t num_anchors, uint32_t row_size,
+                        float threshold, std::vector<YoloDetection> *detections) {
+    detections->clear();
+    if (row_size <= kBoxValues) {
+        return;
+    }
+
+    uint32_t anchor = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t threshold_vector = vdupq_n_f32(threshold);
+
+    for (; anchor + 4 <= num_anchors; anchor += 4) {
+        const float *rows = output + static_cast<size_t>(anchor) * row_size;
+        const uint32_t mask = objectness_mask(rows, row_size, threshold_vector);
+
+        for (uint32_t i = 0; mask != 0 && i < 4; i++) {
+            if (mask & (1u << i)) {
+                decode_row(rows + i * row_size, row_size, threshold, detections);
+            }
+        }
+    }
+#endif
+
+    for (; anchor < num_anchors; anchor++) {
+        decode_row(output + static_cast<size_t>(anchor) * row_size, row_size, threshold,
+                   detections);
+    }
+}
+
+void decode_yolo_output(const uint8_t *output, uint32_t num_anchors, uint32_t row_size,
+                        float threshold, std::vector<YoloDetection> *detections) {
+    detections->clear();
+    if (row_size <= kBoxValues) {
+        return;
+    }
+
+    for (uint32_t anchor = 0; anchor < num_anchors; anchor++) {
+        decode_row(output + static_cast<size_t>(anchor) * row_size, row_size, threshold,
+                   detections);
+    }
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Decoded box in input image coordinates
+struct YoloDetection {
+    float left;
+    float top;
+    float right;
+    float bottom;
+    float score;
+    int32_t class_id;
+};
+
+/**
+ * @brief Decodes a YOLOv5 output tensor in place.
+ *
+ * Each row holds cx, cy, w, h, objectness and the class scores. Rows whose
+ * objectness and best class score both reach threshold are appended to
+ * detections. Ties between classes resolve to the lowest class index.
+ *
+ * @param output Pointer to num_anchors * row_size values.
+ * @param num_anchors Number of rows.
+ * @param row_size Values per row, 5 + number of classes.
+ * @param threshold Minimum objectness and class score.
+ * @param detections Receives the decoded boxes (cleared first).
+ */
+void decode_yolo_output(const float *output, uint32_t num_anchors, uint32_t row_size,
+                        float threshold, std::vector<YoloDetection> *detections);
+
+/**
+ * @brief uint8 variant of decode_yolo_output for quantized models.
+ *
+ * Values are compared and reported as they are, without dequantization.
+ */
+void decode_yolo_output(const uint8_t *output, uint32_t num_anchors, uint32_t row_size,
+                        float threshold, std::vector<YoloDetection> *detections);
@@ -0,0 +1,176 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks decode_yolo_output and suppress_overlapping on fixed test vectors: small
+// YOLOv5 output tensors and detection lists with the boxes expected from them.
+//
+//   yolo_decoder_test
+
+#include <cstdint>
+#include <vector>
+#include "nms.h"
+#include "test_helpers.h"
+#include "yolo_decoder.h"
+
+namespace {
+
+// cx, cy, w, h, objectness and 6 class scores per anchor. 10 anchors, so that arm64
+// checks objectness in 2 blocks of 4 and a scalar tail of 2, and 6 classes, so that
+// the class argmax takes a block of 4 and a tail of 2.
+constexpr uint32_t kRowSize = 11;
+constexpr float kThreshold = 0.5f;
+
+const float FLOAT_OUTPUT[] = {
+        // Kept: class 1
+        100, 100, 40, 20, 0.9f, 0.1f, 0.8f, 0.2f, 0.3f, 0.1f, 0.0f,
+        // Objectness below threshold, even though a class is above
+        50, 50, 10, 10, 0.4f, 0.9f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        // Objectness above threshold, best class below
+        200, 120, 60, 40, 0.7f, 0.2f, 0.3f, 0.1f, 0.4f, 0.45f, 0.49f,
+        // Objectness equal to threshold, tie of classes 0, 1 and 5 resolves to 0
+        300, 300, 100, 50, 0.5f, 0.6f, 0.6f, 0.1f, 0.0f, 0.0f, 0.6f,
+        // Best class equal to threshold, in the class tail
+        10, 20, 4, 8, 0.95f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f,
+        0, 0, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        0, 0, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        // Kept: class 3
+        400, 200, 20, 20, 0.99f, 0.0f, 0.0f, 0.0f, 0.97f, 0.0f, 0.1f,
+        // Anchors of the scalar tail
+        0, 0, 0, 0, 0.3f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+        640, 640, 32, 16, 0.8f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.75f,
+};
+
+const YoloDetection FLOAT_DETECTIONS[] = {
+        {80, 90, 120, 110, 0.8f, 1},
+        {250, 275, 350, 325, 0.6f, 0},
+        {8, 16, 12, 24, 0.5f, 5},
+        {390, 190, 410, 210, 0.97f, 3},
+        {624, 632, 656, 648, 0.75f, 5},
+};
+
+// Quantized values, compared and reported without dequantization
+constexpr float kUInt8Threshold = 128.0f;
+
+const uint8_t UINT8_OUTPUT[] = {
+        100, 100, 40, 20, 230, 25, 204, 51, 76, 25, 0,
+        50, 50, 10, 10, 127, 255, 0, 0, 0, 0, 0,
+        200, 120, 60, 40, 178, 51, 76, 25, 102, 115, 127,
+        255, 255, 100, 50, 128, 153, 153, 25, 0, 0, 153,
+        10, 20, 4, 8, 242, 0, 0, 0, 0, 0, 128,
+};
+
+const YoloDetection UINT8_DETECTIONS[] = {
+        {80, 90, 120, 110, 204, 1},
+        {205, 230, 305, 280, 153, 0},
+        {8, 16, 12, 24, 128, 5},
+};
+
+bool same_detection(const YoloDetection &a, const YoloDetection &b) {
+    return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom &&
+           a.score == b.score && a.class_id == b.class_id;
+}
+
+void check_detections(const char *name, const std::vector<YoloDetection> &detections,
+                      const YoloDetection *expected, size_t expected_count) {
+    EXPECT_TRUE(detections.size() == expected_count, "%s: %zu detections, expected %zu", name,
+                detections.size(), expected_count);
+
+    for (size_t i = 0; i < detections.size() && i < expected_count; i++) {
+        const YoloDetection &box = detections[i];
+        EXPECT_TRUE(same_detection(box, expected[i]),
+                    "%s: detection %zu is (%g, %g, %g, %g) %g class %d, expected "
+                    "(%g, %g, %g, %g) %g class %d", name, i, box.left, box.top, box.right,
+                    box.bottom, box.score, box.class_id, expected[i].left, expected[i].top,
+                    expected[i].right, expected[i].bottom, expected[i].score,
+                    expected[i].class_id);
+    }
+}
+
+void check_decoder() {
+    std::vector<YoloDetection> detections;
+
+    decode_yolo_output(FLOAT_OUTPUT, sizeof(FLOAT_OUTPUT) / sizeof(float) / kRowSize, kRowSize,
+                       kThreshold, &detections);
+    check_detections("float", detections, FLOAT_DETECTIONS,
+                     sizeof(FLOAT_DETECTIONS) / sizeof(YoloDetection));
+
+    decode_yolo_output(UINT8_OUTPUT, sizeof(UINT8_OUTPUT) / kRowSize, kRowSize,
+                       kUInt8Threshold, &detections);
+    check_detections("uint8", detections, UINT8_DETECTIONS,
+                     sizeof(UINT8_DETECTIONS) / sizeof(YoloDetection));
+
+    // Rows without class scores and empty outputs decode to nothing, and previous
+    // detections are cleared
+    decode_yolo_output(FLOAT_OUTPUT, 10, 5, kThreshold, &detections);
+    check_detections("row of 5 values", detections, nullptr, 0);
+    decode_yolo_output(FLOAT_OUTPUT, 0, kRowSize, kThreshold, &detections);
+    check_detections("no anchors", detections, nullptr, 0);
+}
+
+// Decoded boxes of two classes, numbered from 0. With an IoU threshold of 0.5, boxes
+// 0 and 1 are suppressed by box 4 (IoU 1 and 0.68). Box 2 only overlaps a box of
+// another class. Box 5 overlaps box 4 with IoU 0.33, box 6 overlaps box 3 with IoU
+// 0.14 and box 7 overlaps box 5 with IoU 0.2, so they are kept.
+const YoloDetection CANDIDATES[] = {
+        {0, 0, 100, 100, 0.9f, 0},
+        {10, 10, 110, 110, 0.8f, 0},
+        {10, 10, 110, 110, 0.85f, 1},
+        {200, 200, 300, 300, 0.7f, 0},
+        {0, 0, 100, 100, 0.95f, 0},
+        {50, 0, 150, 100, 0.6f, 0},
+        {250, 250, 350, 350, 0.65f, 0},
+        // Touches box 4 along an edge without overlapping it
+        {100, 0, 200, 50, 0.62f, 0},
+};
+
+// Kept boxes in score order
+const YoloDetection KEPT[] = {
+        {0, 0, 100, 100, 0.95f, 0},
+        {10, 10, 110, 110, 0.85f, 1},
+        {200, 200, 300, 300, 0.7f, 0},
+        {250, 250, 350, 350, 0.65f, 0},
+        {100, 0, 200, 50, 0.62f, 0},
+        {50, 0, 150, 100, 0.6f, 0},
+};
+
+constexpr size_t kCandidates = sizeof(CANDIDATES) / sizeof(YoloDetection);
+constexpr size_t kKept = sizeof(KEPT) / sizeof(YoloDetection);
+
+void check_nms() {
+    for (NmsMethod method : {NMS_METHOD_GREEDY, NMS_METHOD_GRID}) {
+        const char *name = method == NMS_METHOD_GREEDY ? "greedy" : "grid";
+        std::vector<YoloDetection> detections(CANDIDATES, CANDIDATES + kCandidates);
+
+        suppress_overlapping(&detections, method, 0.5f, 100);
+        check_detections(name, detections, KEPT, kKept);
+
+        // The highest scoring boxes are kept first
+        detections.assign(CANDIDATES, CANDIDATES + kCandidates);
+        suppress_overlapping(&detections, method, 0.5f, 3);
+        check_detections(name, detections, KEPT, 3);
+
+        // With an IoU threshold of 0 any overlap suppresses, which drops boxes 5 and 6.
+        // Box 7 only touches box 4 and is visited before box 5.
+        detections.assign(CANDIDATES, CANDIDATES + kCandidates);
+        suppress_overlapping(&detections, method, 0.0f, 100);
+        const YoloDetection no_overlap[] = {KEPT[0], KEPT[1], KEPT[2], KEPT[4]};
+        check_detections(name, detections, no_overlap, 4);
+
+        detections.clear();
+        suppress_overlapping(&detections, method, 0.5f, 100);
+        check_detections(name, detections, nullptr, 0);
+    }
+
+    // Without suppression the boxes stay in decode order, up to max_detections
+    std::vector<YoloDetection> detections(CANDIDATES, CANDIDATES + kCandidates);
+    suppress_overlapping(&detections, NMS_METHOD_NONE, 0.5f, 4);
+    check_detections("none", detections, CANDIDATES, 4);
+}
+
+}  // namespace
+
+int main() {
+    check_decoder();
+    check_nms();
+
+    return TestResult("yolo_decoder_test");
+}
@@ -6,14 +6,12 @@ import android.content.Context
 import android.graphics.Bitmap
 import android.os.SystemClock
 import com.samsung.imageclassification.data.DataType
-import com.samsung.imageclassification.data.LayerType
 import com.samsung.imageclassification.data.ModelConstants
 import com.samsung.imageclassification.enn_type.BufferSetInfo
 import java.io.File
 import java.io.FileOutputStream
 import java.io.IOException
 import java.nio.ByteBuffer
-import java.nio.ByteOrder
 
 
 @Suppress("IMPLICIT_CAST_TO_ANY")
@@ -23,21 +21,56 @@ class ModelExecutor(
     val context: Context,
     val executorListener: ExecutorListener?
 ) {
-    private external fun ennInitialize()
+    private external fun ennInitialize(preferencesPath: String)
     private external fun ennDeinitialize()
     private external fun ennOpenModel(filename: String): Long
     private external fun ennCloseModel(modelId: Long)
     private external fun ennAllocateAllBuffers(modelId: Long): BufferSetInfo
     private external fun ennReleaseBuffers(bufferSet: Long, bufferSize: Int)
     private external fun ennExecute(modelId: Long)
-    private external fun ennMemcpyHostToDevice(bufferSet: Long, layerNumber: Int, data: ByteArray)
-    private external fun ennMemcpyDeviceToHost(bufferSet: Long, layerNumber: Int): ByteArray
+    private external fun ennBufferView(bufferSet: Long, layerNumber: Int): ByteBuffer
+    private external fun ennConvertBitmapToFloat(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertBitmapToUInt8(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertFrameToFloat(
+        bufferSet: Long, layerNumber: Int, frame: ByteBuffer, frameWidth: Int, frameHeight: Int,
+        rowStride: Int, rotation: Int, width: Int, height: Int, layerType: Int, offset: Float,
+        scale: Float
+    )
+    private external fun ennConvertFrameToUInt8(
+        bufferSet: Long, layerNumber: Int, frame: ByteBuffer, frameWidth: Int, frameHeight: Int,
+        rowStride: Int, rotation: Int, width: Int, height: Int, layerType: Int, offset: Float,
+        scale: Float
+    )
+    private external fun ennSelectTopK(
+        output: ByteBuffer, dataType: Int, count: Int, k: Int, threshold: Float,
+        offset: Float, scale: Float, dequantize: FloatArray
+    ): FloatArray
+    private external fun ennCreateBufferRing(modelId: Long, depth: Int): Long
+    private external fun ennRingBufferSet(bufferRing: Long, slot: Int): Long
+    private external fun ennRingExecuteAsync(bufferRing: Long, slot: Int)
+    private external fun ennRingWait(bufferRing: Long, slot: Int): Long
+    private external fun ennReleaseBufferRing(bufferRing: Long)
 
     private var modelId: Long = 0
     private var bufferSet: Long = 0
     private var nInBuffer: Int = 0
     private var nOutBuffer: Int = 0
 
+    // Created on the first processStream() call, 0 if the sessions could not be allocated
+    private var bufferRing: Long? = null
+    private var ringHead: Int = 0
+    private var ringInFlight: Int = 0
+
+    // Set by closeENN(), after which processStream() drops frames
+    @Volatile
+    private var closed = false
+
     init {
         System.loadLibrary("enn_jni")
         copyNNCFromAssetsToInternalStorage(MODEL_NAME)
@@ -46,8 +79,8 @@ class ModelExecutor(
     }
 
     private fun setupENN() {
-        // Initialize ENN
-        ennInitialize()
+        // Initialize ENN with the preferences tuned by enn_nnc_model_tester, if shipped
+        ennInitialize(copyPreferencesFromAssetsToInternalStorage())
 
         // Open model
         val fileAbsoluteDirectory = File(context.filesDir, MODEL_NAME).absolutePath
@@ -61,24 +94,95 @@ class ModelExecutor(
     }
 
     fun process(image: Bitmap) {
-        // Process Image to Input Byte Array
-        val input = preProcess(image)
-        // Copy Input Data
-        ennMemcpyHostToDevice(bufferSet, 0, input)
+        process { bufferSet -> preProcess(image, bufferSet) }
+    }
+
+    private fun process(writeInput: (Long) -> Unit) {
+        // Process Image into the Input Buffer
+        writeInput(bufferSet)
 
         var inferenceTime = SystemClock.uptimeMillis()
         // Model execute
         ennExecute(modelId)
         inferenceTime = SystemClock.uptimeMillis() - inferenceTime
-        // Copy Output Data
-        val output = ennMemcpyDeviceToHost(bufferSet, nInBuffer)
+        // Map Output Data
+        val output = ennBufferView(bufferSet, nInBuffer)
 
         executorListener?.onResults(
             postProcess(output), inferenceTime
         )
     }
 
+    // Pipelined variant of process() for camera streams: the input of this frame is
+    // written to a free session while the previous frame still executes, so results
+    // are delivered BUFFER_RING_DEPTH - 1 frames late. The frame is read before this returns,
+    // see preProcessFrame().
+    fun processStream(
+        frame: ByteBuffer, frameWidth: Int, frameHeight: Int, rowStride: Int, rotation: Int
+    ) {
+        if (closed) {
+            return
+        }
+
+        val writeInput = { bufferSet: Long ->
+            preProcessFrame(frame, frameWidth, frameHeight, rowStride, rotation, bufferSet)
+        }
+        val ring = bufferRing ?: ennCreateBufferRing(modelId, BUFFER_RING_DEPTH).also {
+            bufferRing = it
+        }
+        if (ring == 0L) {
+            process(writeInput)
+            return
+        }
+
+        val slot = ringHead
+        // Process Image into the Input Buffer
+        writeInput(ennRingBufferSet(ring, slot))
+        // Model execute
+        ennRingExecuteAsync(ring, slot)
+        ringHead = (slot + 1) % BUFFER_RING_DEPTH
+        ringInFlight++
+
+        // Once every session is in flight, the oldest one is the next to be filled
+        if (ringInFlight == BUFFER_RING_DEPTH) {
+            collectStream(ring, ringHead)
+        }
+    }
+
+    private fun collectStream(ring: Long, slot: Int) {
+        // Time from submission to completion of the frame, measured natively so that it
+        // excludes the wait for the frame that collects it
+        val inferenceTime = ennRingWait(ring, slot)
+        ringInFlight--
+        if (inferenceTime < 0) {
+            return
+        }
+        // Map Output Data
+        val output = ennBufferView(ennRingBufferSet(ring, slot), nInBuffer)
+
+        executorListener?.onResults(
+            postProcess(output), inferenceTime
+        )
+    }
+
+    // Must run on the thread that calls processStream(), after its last call, so that the
+    // sessions are not released while a frame uses them
     fun closeENN() {
+        if (closed) {
+            return
+        }
+        closed = true
+
+        // Deliver the results of frames still in flight, then release the streaming sessions
+        bufferRing?.takeIf { it != 0L }?.let { ring ->
+            while (ringInFlight > 0) {
+                // Oldest session in flight
+                val slot = (ringHead - ringInFlight + BUFFER_RING_DEPTH) % BUFFER_RING_DEPTH
+                collectStream(ring, slot)
+            }
+            ennReleaseBufferRing(ring)
+        }
+        bufferRing = null
         // Release a buffer array
         ennReleaseBuffers(bufferSet, nInBuffer + nOutBuffer)
         // Close a Model and Free all resources
@@ -87,145 +191,80 @@ class ModelExecutor(
         ennDeinitialize()
     }
 
-    private fun preProcess(image: Bitmap): ByteArray {
-        val byteArray = when (INPUT_DATA_TYPE) {
+    // Writes the converted image straight into the ENN input buffer
+    private fun preProcess(image: Bitmap, bufferSet: Long) {
+        when (INPUT_DATA_TYPE) {
             DataType.UINT8 -> {
-                convertBitmapToUByteArray(image, INPUT_DATA_LAYER).asByteArray()
+                ennConvertBitmapToUInt8(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             DataType.FLOAT32 -> {
-                val data = convertBitmapToFloatArray(image, INPUT_DATA_LAYER)
-                val byteBuffer = ByteBuffer.allocate(data.size * Float.SIZE_BYTES)
-                byteBuffer.order(ByteOrder.nativeOrder())
-                byteBuffer.asFloatBuffer().put(data)
-                byteBuffer.array()
+                ennConvertBitmapToFloat(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             else -> {
                 throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
         }
-
-        return byteArray
     }
 
-    private fun postProcess(modelOutput: ByteArray): Map<String, Float> {
-        val output = when (OUTPUT_DATA_TYPE) {
+    // Rotates, scales and center crops the camera frame straight into the ENN input buffer,
+    // in one native pass over its RGBA_8888 plane
+    private fun preProcessFrame(
+        frame: ByteBuffer, frameWidth: Int, frameHeight: Int, rowStride: Int, rotation: Int,
+        bufferSet: Long
+    ) {
+        when (INPUT_DATA_TYPE) {
             DataType.UINT8 -> {
-                modelOutput.asUByteArray().mapIndexed { index, value ->
-                    labelList[index] to dequantizedValues[((value.toInt()
-                            - OUTPUT_CONVERSION_OFFSET)
-                            / OUTPUT_CONVERSION_SCALE).toInt()]
-                }.filter { it.second >= threshold }.sortedByDescending { it.second }.toMap()
+                ennConvertFrameToUInt8(
+                    bufferSet, 0, frame, frameWidth, frameHeight, rowStride, rotation,
+                    INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             DataType.FLOAT32 -> {
-                val byteBuffer = ByteBuffer.wrap(modelOutput).order(ByteOrder.nativeOrder())
-                val floatBuffer = byteBuffer.asFloatBuffer()
-                val data = FloatArray(floatBuffer.remaining())
-
-                floatBuffer.get(data)
-                data.mapIndexed { index, value ->
-                    labelList[index] to ((value
-                            - OUTPUT_CONVERSION_OFFSET)
-                            / OUTPUT_CONVERSION_SCALE)
-                }.filter { it.second >= threshold }.sortedByDescending { it.second }.toMap()
+                ennConvertFrameToFloat(
+                    bufferSet, 0, frame, frameWidth, frameHeight, rowStride, rotation,
+                    INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             else -> {
-                throw IllegalArgumentException("Unsupported output data type: ${OUTPUT_DATA_TYPE}")
+                throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
         }
-
-        return output
     }
 
-    private fun convertBitmapToUByteArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): UByteArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
+    private fun postProcess(modelOutput: ByteBuffer): Map<String, Float> {
+        // index, score pairs of the best classes, dequantized only for the survivors
+        val selected = ennSelectTopK(
+            modelOutput, OUTPUT_DATA_TYPE.ordinal, labelList.size, TOP_K, threshold,
+            OUTPUT_CONVERSION_OFFSET, OUTPUT_CONVERSION_SCALE, dequantizedValues
         )
 
-        val uByteArray = UByteArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
-        } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            uByteArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
+        return (selected.indices step 2).associate { i ->
+            labelList[selected[i].toInt()] to selected[i + 1]
         }
-
-        return uByteArray
     }
 
-    private fun convertBitmapToFloatArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): FloatArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
-        )
+    // Returns the path of the preferences file, which only exists if the app ships one
+    private fun copyPreferencesFromAssetsToInternalStorage(): String {
+        val preferencesFile = File(context.filesDir, PREFERENCES_FILE)
 
-        val floatArray = FloatArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
+        if (context.assets.list("")?.contains(PREFERENCES_FILE) == true) {
+            copyNNCFromAssetsToInternalStorage(PREFERENCES_FILE)
         } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            floatArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
+            preferencesFile.delete()
         }
-
-        return floatArray
+        return preferencesFile.absolutePath
     }
 
     private fun copyNNCFromAssetsToInternalStorage(filename: String) {
@@ -264,7 +303,7 @@ class ModelExecutor(
 
     companion object {
         var labelList: List<String> = mutableListOf()
-        val dequantizedValues = List(256) { it.toFloat() * 0.00390625F }
+        val dequantizedValues = FloatArray(256) { it.toFloat() * 0.00390625F }
 
         private const val MODEL_NAME = ModelConstants.MODEL_NAME
 
@@ -273,7 +312,6 @@ class ModelExecutor(
 
         private const val INPUT_SIZE_W = ModelConstants.INPUT_SIZE_W
         private const val INPUT_SIZE_H = ModelConstants.INPUT_SIZE_H
-        private const val INPUT_SIZE_C = ModelConstants.INPUT_SIZE_C
 
         private const val INPUT_CONVERSION_SCALE = ModelConstants.INPUT_CONVERSION_SCALE
         private const val INPUT_CONVERSION_OFFSET = ModelConstants.INPUT_CONVERSION_OFFSET
@@ -284,5 +322,14 @@ class ModelExecutor(
         private const val OUTPUT_CONVERSION_OFFSET = ModelConstants.OUTPUT_CONVERSION_OFFSET
 
         private const val LABEL_FILE = ModelConstants.LABEL_FILE
+
+        // Number of labels shown by the fragments
+        private const val TOP_K = 3
+
+        // Written by enn_nnc_model_tester --sweep-preferences
+        private const val PREFERENCES_FILE = "enn_preferences.cfg"
+
+        // Number of sessions kept in flight by processStream()
+        private const val BUFFER_RING_DEPTH = 2
     }
 }
@@ -4,17 +4,14 @@ package com.samsung.imageenhance.executor
 
 import android.content.Context
 import android.graphics.Bitmap
-import android.graphics.Color
 import android.os.SystemClock
 import com.samsung.imageenhance.data.DataType
-import com.samsung.imageenhance.data.LayerType
 import com.samsung.imageenhance.data.ModelConstants
 import com.samsung.imageenhance.enn_type.BufferSetInfo
 import java.io.File
 import java.io.FileOutputStream
 import java.io.IOException
 import java.nio.ByteBuffer
-import java.nio.ByteOrder
 
 
 @Suppress("IMPLICIT_CAST_TO_ANY")
@@ -23,15 +20,26 @@ class ModelExecutor(
     val context: Context,
     val executorListener: ExecutorListener?
 ) {
-    private external fun ennInitialize()
+    private external fun ennInitialize(preferencesPath: String)
     private external fun ennDeinitialize()
     private external fun ennOpenModel(filename: String): Long
     private external fun ennCloseModel(modelId: Long)
     private external fun ennAllocateAllBuffers(modelId: Long): BufferSetInfo
     private external fun ennReleaseBuffers(bufferSet: Long, bufferSize: Int)
     private external fun ennExecute(modelId: Long)
-    private external fun ennMemcpyHostToDevice(bufferSet: Long, layerNumber: Int, data: ByteArray)
-    private external fun ennMemcpyDeviceToHost(bufferSet: Long, layerNumber: Int): ByteArray
+    private external fun ennBufferView(bufferSet: Long, layerNumber: Int): ByteBuffer
+    private external fun ennConvertBitmapToFloat(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertBitmapToUInt8(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennPackOutputToBitmap(
+        output: ByteBuffer, dataType: Int, width: Int, height: Int, layerType: Int,
+        scale: Float, offset: Float, image: Bitmap
+    )
 
     private var modelId: Long = 0
     private var bufferSet: Long = 0
@@ -45,8 +53,8 @@ class ModelExecutor(
     }
 
     private fun setupENN() {
-        // Initialize ENN
-        ennInitialize()
+        // Initialize ENN with the preferences tuned by enn_nnc_model_tester, if shipped
+        ennInitialize(copyPreferencesFromAssetsToInternalStorage())
 
         // Open model
         val fileAbsoluteDirectory = File(context.filesDir, MODEL_NAME).absolutePath
@@ -60,20 +68,18 @@ class ModelExecutor(
     }
 
     fun process(image: Bitmap) {
-        // Process Image to Input Byte Array
-        val input = preProcess(image)
-        // Copy Input Data
-        ennMemcpyHostToDevice(bufferSet, 0, input)
+        // Process Image into the Input Buffer
+        preProcess(image, bufferSet)
 
         var inferenceTime = SystemClock.uptimeMillis()
         // Model execute
         ennExecute(modelId)
         inferenceTime = SystemClock.uptimeMillis() - inferenceTime
-        // Copy Output Data
-        val output = ennMemcpyDeviceToHost(bufferSet, nInBuffer)
+        // Map Output Data
+        val output = ennBufferView(bufferSet, nInBuffer)
 
         executorListener?.onResults(
-            postProcess(output, OUTPUT_DATA_LAYER), inferenceTime
+            postProcess(output), inferenceTime
         )
     }
 
@@ -86,166 +92,51 @@ class ModelExecutor(
         ennDeinitialize()
     }
 
-    private fun preProcess(image: Bitmap): ByteArray {
-        val byteArray = when (INPUT_DATA_TYPE) {
+    // Writes the converted image straight into the ENN input buffer
+    private fun preProcess(image: Bitmap, bufferSet: Long) {
+        when (INPUT_DATA_TYPE) {
             DataType.UINT8 -> {
-                convertBitmapToUByteArray(image, INPUT_DATA_LAYER).asByteArray()
+                ennConvertBitmapToUInt8(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             DataType.FLOAT32 -> {
-                val data = convertBitmapToFloatArray(image, INPUT_DATA_LAYER)
-                val byteBuffer = ByteBuffer.allocate(data.size * Float.SIZE_BYTES)
-                byteBuffer.order(ByteOrder.nativeOrder())
-                byteBuffer.asFloatBuffer().put(data)
-                byteBuffer.array()
+                ennConvertBitmapToFloat(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             else -> {
                 throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
         }
-
-        return byteArray
     }
 
-    private fun postProcess(
-        output: ByteArray, layerType: Enum<LayerType> = LayerType.HWC
-    ): IntArray {
-        val totalPixels = INPUT_SIZE_W * INPUT_SIZE_H
-        val data = convertOutputByteToFloatArray(output)
-
-        val (offset, stride) = if (layerType == LayerType.CHW) {
-            Pair(intArrayOf(0, totalPixels, 2 * totalPixels), 1)
-        } else {
-            Pair(intArrayOf(0, 1, 2), 3)
-        }
-
-        return IntArray(OUTPUT_SIZE_W * OUTPUT_SIZE_H) { i ->
-            convertToArgb(
-                r = data[i * stride + offset[0]],
-                g = data[i * stride + offset[1]],
-                b = data[i * stride + offset[2]],
-                a = 255
-            )
-        }
-    }
-
-    private fun convertToArgb(r: Float, g: Float, b: Float, a: Int): Int {
-        val red = (r * OUTPUT_CONVERSION_SCALE + OUTPUT_CONVERSION_OFFSET).toInt()
-        val green = (g * OUTPUT_CONVERSION_SCALE + OUTPUT_CONVERSION_OFFSET).toInt()
-        val blue = (b * OUTPUT_CONVERSION_SCALE + OUTPUT_CONVERSION_OFFSET).toInt()
-        return Color.argb(a, red, green, blue)
-    }
+    private fun postProcess(output: ByteBuffer): Bitmap {
+        val image = Bitmap.createBitmap(OUTPUT_SIZE_W, OUTPUT_SIZE_H, Bitmap.Config.ARGB_8888)
 
-    private fun convertBitmapToUByteArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): UByteArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
+        // Channels are scaled and saturated to 0..255 straight into the bitmap pixels
+        ennPackOutputToBitmap(
+            output, OUTPUT_DATA_TYPE.ordinal, OUTPUT_SIZE_W, OUTPUT_SIZE_H,
+            OUTPUT_DATA_LAYER.ordinal, OUTPUT_CONVERSION_SCALE, OUTPUT_CONVERSION_OFFSET, image
         )
 
-        val uByteArray = UByteArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
-        } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            uByteArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-        }
-
-        return uByteArray
+        return image
     }
 
-    private fun convertBitmapToFloatArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): FloatArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
-        )
-
-        val floatArray = FloatArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
+    // Returns the path of the preferences file, which only exists if the app ships one
+    private fun copyPreferencesFromAssetsToInternalStorage(): String {
+        val preferencesFile = File(context.filesDir, PREFERENCES_FILE)
 
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
+        if (context.assets.list("")?.contains(PREFERENCES_FILE) == true) {
+            copyNNCFromAssetsToInternalStorage(PREFERENCES_FILE)
         } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            floatArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-        }
-
-        return floatArray
-    }
-
-    private fun convertOutputByteToFloatArray(
-        modelOutput: ByteArray
-    ): FloatArray {
-        return when (OUTPUT_DATA_TYPE) {
-            DataType.UINT8 -> {
-                modelOutput.toUByteArray().map { it.toFloat() }.toFloatArray()
-            }
-
-            DataType.FLOAT32 -> {
-                val byteBuffer = ByteBuffer.wrap(modelOutput).order(ByteOrder.nativeOrder())
-                val floatBuffer = byteBuffer.asFloatBuffer()
-                val floatArray = FloatArray(floatBuffer.remaining())
-
-                floatBuffer.get(floatArray)
-                floatArray
-            }
-
-            else -> {
-                throw IllegalArgumentException("Unsupported output data type: ${OUTPUT_DATA_TYPE}")
-            }
+            preferencesFile.delete()
         }
+        return preferencesFile.absolutePath
     }
 
     private fun copyNNCFromAssetsToInternalStorage(filename: String) {
@@ -269,7 +160,7 @@ class ModelExecutor(
     interface ExecutorListener {
         fun onError(error: String)
         fun onResults(
-            pixels: IntArray, inferenceTime: Long
+            image: Bitmap, inferenceTime: Long
         )
     }
 
@@ -283,7 +174,6 @@ class ModelExecutor(
 
         private const val INPUT_SIZE_W = ModelConstants.INPUT_SIZE_W
         private const val INPUT_SIZE_H = ModelConstants.INPUT_SIZE_H
-        private const val INPUT_SIZE_C = ModelConstants.INPUT_SIZE_C
 
         private const val INPUT_CONVERSION_SCALE = ModelConstants.INPUT_CONVERSION_SCALE
         private const val INPUT_CONVERSION_OFFSET = ModelConstants.INPUT_CONVERSION_OFFSET
@@ -293,9 +183,11 @@ class ModelExecutor(
 
         private const val OUTPUT_SIZE_W = ModelConstants.OUTPUT_SIZE_W
         private const val OUTPUT_SIZE_H = ModelConstants.OUTPUT_SIZE_H
-        private const val OUTPUT_SIZE_C = ModelConstants.OUTPUT_SIZE_C
 
         private const val OUTPUT_CONVERSION_SCALE = ModelConstants.OUTPUT_CONVERSION_SCALE
         private const val OUTPUT_CONVERSION_OFFSET = ModelConstants.OUTPUT_CONVERSION_OFFSET
+
+        // Written by enn_nnc_model_tester --sweep-preferences
+        private const val PREFERENCES_FILE = "enn_preferences.cfg"
     }
 }
@@ -110,18 +110,11 @@ class ImageFragment : Fragment(), ModelExecutor.ExecutorListener {
     }
 
     override fun onResults(
-        pixels: IntArray, inferenceTime: Long
+        image: Bitmap, inferenceTime: Long
     ) {
         activity?.runOnUiThread {
-            val bitmap = Bitmap.createBitmap(
-                pixels,
-                ModelConstants.OUTPUT_SIZE_W,
-                ModelConstants.OUTPUT_SIZE_H,
-                Bitmap.Config.ARGB_8888
-            )
-
             binding.setting.inferenceTime.text = "$inferenceTime ms"
-            binding.outputImage.setImageBitmap(bitmap)
+            binding.outputImage.setImageBitmap(image)
         }
     }
 
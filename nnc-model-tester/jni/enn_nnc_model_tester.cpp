@@ -2,54 +2,1053 @@
 
 #include "include/enn_nnc_model_tester.h"
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
-#include "include/CLI11.hpp"
-#include "include/enn_api-public_ndk_v1.hpp"
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "include/CLI11.hpp"
+#include "include/enn_api-public_ndk_v1.hpp"
+
+// The benchmark links this file for its kernels and brings its own main()
+#ifndef ENN_NNC_MODEL_TESTER_NO_MAIN
+int main(int argc, char *argv[]) {
+    std::vector<std::string> model_names;
+    std::vector<std::string> inputs;
+    std::vector<std::string> goldens;
+    int iteration = 1;
+    bool force = false;
+    float threshold = 0.0F;
+    BenchmarkOptions benchmark;
+    DatasetOptions dataset;
+
+    parse_arguments(argc, argv, model_names, inputs, goldens, iteration, force,
+                    threshold, benchmark, dataset);
+
+    const bool sweep = !dataset.manifest.empty() || !dataset.input_dir.empty();
+    int result;
+
+    if (model_names.size() > 1) {
+        if (!inputs.empty() || !goldens.empty() || sweep) {
+            std::cerr << "Several models run without input data, remove the "
+                         "--input, --golden and dataset options."
+                      << std::endl;
+            return FAILURE;
+        }
+
+        result = execute_concurrent(model_names, iteration, benchmark);
+    } else {
+        if (inputs.empty() && !force && !sweep) {
+            std::cerr
+                << "You must provide input data files or use the --force flag."
+                << std::endl;
+            return FAILURE;
+        }
+
+        result = benchmark.profile_lifecycle
+                     ? profile_lifecycle(model_names[0], inputs, force,
+                                         iteration, benchmark)
+                     : execute_model(model_names[0], inputs, goldens, force,
+                                     threshold, iteration, benchmark,
+                                     dataset);
+    }
+
+    if (result) {
+        std::cerr << ERROR_COLOR << "[[Failed to Execute Model]]" << RESET_COLOR
+                  << std::endl;
+        return FAILURE;
+    }
+    std::cout << SUCCESS_COLOR << "ENN Framework Execute Model Sucess"
+              << RESET_COLOR << std::endl;
+}
+#endif
+
+int execute_model(const std::string model_name,
+                  const std::vector<std::string> &inputs,
+                  const std::vector<std::string> &goldens,
+                  const bool force_mode, const float threshold,
+                  const int iteration, const BenchmarkOptions &benchmark,
+                  const DatasetOptions &dataset) {
+    if (enn::api::EnnInitialize()) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Initialize" << std::endl;
+        return FAILURE;
+    }
+
+    if (benchmark.sweep_preferences) {
+        // Each combination opens the model itself, once it is set
+        int result = run_preference_sweep(model_name, inputs, force_mode,
+                                          iteration, benchmark);
+        if (enn::api::EnnDeinitialize()) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Deinitialize" << std::endl;
+            return FAILURE;
+        }
+        return result;
+    }
+
+    EnnModelId model_id;
+
+    if (enn::api::EnnOpenModel(model_name.c_str(), &model_id)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Open Model" << std::endl;
+        return FAILURE;
+    } else {
+        std::cout << "Loaded Model:\n\t" << model_name << "(" << STDOUT_64HEX
+                  << model_id << std::dec << ")" << std::endl;
+    }
+
+    EnnBufferPtr *buffer_set;
+    NumberOfBuffersInfo buffer_info;
+
+    if (enn::api::EnnAllocateAllBuffers(model_id, &buffer_set, &buffer_info)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Allocate Buffers" << std::endl;
+        return FAILURE;
+    }
+
+    if (!dataset.manifest.empty() || !dataset.input_dir.empty()) {
+        std::vector<DatasetSample> samples;
+
+        int result = dataset.manifest.empty()
+                         ? scan_input_dir(dataset.input_dir, buffer_info,
+                                          samples)
+                         : load_manifest(dataset.manifest, buffer_info,
+                                         samples);
+        if (!result) {
+            result = run_dataset_sweep(model_id, buffer_set, buffer_info,
+                                       samples, threshold, benchmark);
+        }
+
+        return release_model(model_id, buffer_set, buffer_info) || result;
+    }
+
+    if (!force_mode) {
+        if (load_inputs(buffer_set, buffer_info, inputs)) {
+            std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                      << "\tProblem loading input files" << std::endl;
+            return FAILURE;
+        }
+    }
+
+    // Session 0 holds the buffers above, extra sessions get their own copies
+    std::vector<EnnBufferPtr *> sessions = {buffer_set};
+    const int n_sessions = benchmark.async_mode ? benchmark.inflight : 1;
+
+    for (int session_id = 1; session_id < n_sessions; session_id++) {
+        EnnBufferPtr *session_buffer_set;
+        NumberOfBuffersInfo session_buffer_info;
+
+        if (enn::api::EnnAllocateAllBuffers(model_id, &session_buffer_set,
+                                            &session_buffer_info, session_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Allocate Buffers (session " << session_id
+                      << ")" << std::endl;
+            release_sessions(sessions, buffer_info);
+            return FAILURE;
+        }
+        sessions.push_back(session_buffer_set);
+
+        if (!force_mode &&
+            load_inputs(session_buffer_set, session_buffer_info, inputs)) {
+            std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                      << "\tProblem loading input files (session "
+                      << session_id << ")" << std::endl;
+            release_sessions(sessions, buffer_info);
+            return FAILURE;
+        }
+    }
+
+    for (int idx = 0; idx < benchmark.warmup; idx++) {
+        if (enn::api::EnnExecuteModel(model_id, idx % n_sessions)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Execute Model (warmup)" << std::endl;
+            release_sessions(sessions, buffer_info);
+            return FAILURE;
+        }
+    }
+
+    if (benchmark.warmup > 0) {
+        std::cout << "Warmup Iterations: " << benchmark.warmup << std::endl;
+    }
+
+    std::vector<int64_t> durations;
+    auto bench_start = std::chrono::high_resolution_clock::now();
+
+    int result = benchmark.async_mode
+                     ? run_async_pipeline(model_id, n_sessions, iteration,
+                                          benchmark, durations)
+                     : run_sync_loop(model_id, iteration, benchmark, durations);
+
+    auto bench_end = std::chrono::high_resolution_clock::now();
+
+    if (result) {
+        release_sessions(sessions, buffer_info);
+        return FAILURE;
+    }
+
+    if (!durations.empty()) {
+        auto wall_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                             bench_end - bench_start)
+                             .count();
+        LatencyStats stats = compute_latency_stats(durations);
+        stats.throughput =
+            durations.size() * 1e6 / std::max<int64_t>(wall_time, 1);
+        print_latency_stats(stats);
+
+        if (benchmark.async_mode) {
+            // Sum of per-request latencies over wall time estimates how much
+            // the requests overlapped as seen from the host, queueing
+            // included. It is bounded by the number of async sessions and
+            // is not a concurrency measured on the NPU.
+            std::cout << std::fixed << std::setprecision(2)
+                      << "-\tasync sessions:" << n_sessions
+                      << "  latency overlap:"
+                      << stats.mean * stats.count /
+                             std::max<int64_t>(wall_time, 1)
+                      << std::endl;
+            std::cout.unsetf(std::ios_base::floatfield);
+            std::cout << std::setprecision(6);
+        }
+
+        if (benchmark.histogram_bins > 0) {
+            print_latency_histogram(durations, stats, benchmark.histogram_bins);
+        }
+
+        if (!benchmark.report_format.empty() &&
+            write_benchmark_report(model_name, benchmark, durations, stats)) {
+            std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
+                      << "\tFailed to write benchmark report" << std::endl;
+            release_sessions(sessions, buffer_info);
+            return FAILURE;
+        }
+    }
+
+    sessions.erase(sessions.begin());
+    release_sessions(sessions, buffer_info);
+
+    if (!force_mode) {
+        process_outputs(model_id, buffer_set, buffer_info, goldens, threshold);
+    }
+
+    return release_model(model_id, buffer_set, buffer_info);
+}
+
+int release_model(const EnnModelId model_id, EnnBufferPtr *buffer_set,
+                  const NumberOfBuffersInfo buffer_info) {
+    if (enn::api::EnnReleaseBuffers(
+            buffer_set, buffer_info.n_in_buf + buffer_info.n_out_buf)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Release Buffers" << std::endl;
+        return FAILURE;
+    }
+
+    if (enn::api::EnnCloseModel(model_id)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Close Model" << std::endl;
+        return FAILURE;
+    }
+
+    if (enn::api::EnnDeinitialize()) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Deinitialize" << std::endl;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+// Removes leading and trailing blanks of a manifest field
+std::string trim_field(const std::string &field) {
+    const size_t begin = field.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+
+    return field.substr(begin, field.find_last_not_of(" \t\r") - begin + 1);
+}
+
+int load_manifest(const std::string &manifest,
+                  const NumberOfBuffersInfo buffer_info,
+                  std::vector<DatasetSample> &samples) {
+    std::ifstream file(manifest);
+
+    if (!file) {
+        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                  << "\tCannot open file(" << manifest << ")" << std::endl;
+        return FAILURE;
+    }
+
+    const size_t slash = manifest.rfind('/');
+    const std::string base =
+        slash == std::string::npos ? "" : manifest.substr(0, slash + 1);
+    const size_t n_in_buf = buffer_info.n_in_buf;
+    const size_t n_out_buf = buffer_info.n_out_buf;
+    std::string line;
+
+    for (int line_no = 1; std::getline(file, line); line_no++) {
+        line = trim_field(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::vector<std::string> fields;
+        std::stringstream row(line);
+        std::string field;
+
+        while (std::getline(row, field, ',')) {
+            fields.push_back(trim_field(field));
+        }
+
+        if (fields.size() != n_in_buf &&
+            fields.size() != n_in_buf + n_out_buf) {
+            std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                      << "\tManifest line " << line_no << ": Expected "
+                      << n_in_buf << " input files, optionally followed by "
+                      << n_out_buf << " golden files" << std::endl;
+            return FAILURE;
+        }
+
+        DatasetSample sample;
+        sample.name = fields[0];
+
+        for (size_t idx = 0; idx < fields.size(); idx++) {
+            std::string path =
+                fields[idx][0] == '/' ? fields[idx] : base + fields[idx];
+            if (idx < n_in_buf) {
+                sample.inputs.push_back(path);
+            } else {
+                sample.goldens.push_back(path);
+            }
+        }
+        samples.push_back(sample);
+    }
+
+    if (samples.empty()) {
+        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                  << "\tNo samples in manifest(" << manifest << ")"
+                  << std::endl;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+int scan_input_dir(const std::string &input_dir,
+                   const NumberOfBuffersInfo buffer_info,
+                   std::vector<DatasetSample> &samples) {
+    DIR *dir = opendir(input_dir.c_str());
+
+    if (!dir) {
+        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                  << "\tCannot open directory(" << input_dir << ")"
+                  << std::endl;
+        return FAILURE;
+    }
+
+    std::vector<std::string> names;
+
+    for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+        struct stat st;
+        const std::string path = input_dir + "/" + entry->d_name;
+
+        if (entry->d_name[0] != '.' && !stat(path.c_str(), &st) &&
+            S_ISDIR(st.st_mode)) {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    for (const auto &name : names) {
+        DatasetSample sample;
+        const std::string path = input_dir + "/" + name + "/";
+        sample.name = name;
+
+        for (uint32_t idx = 0; idx < buffer_info.n_in_buf; idx++) {
+            sample.inputs.push_back(path + "input" + std::to_string(idx) +
+                                    ".bin");
+        }
+        // Goldens are optional, but a checked sample needs all of them
+        if (!access((path + "golden0.bin").c_str(), F_OK)) {
+            for (uint32_t idx = 0; idx < buffer_info.n_out_buf; idx++) {
+                sample.goldens.push_back(path + "golden" +
+                                         std::to_string(idx) + ".bin");
+            }
+        }
+        samples.push_back(sample);
+    }
+
+    if (samples.empty()) {
+        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                  << "\tNo sample directories in(" << input_dir << ")"
+                  << std::endl;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+// Files of one dataset sample, mapped ahead of its execution
+typedef struct _PrefetchedSample {
+    int status = SUCCESS;
+    std::vector<MappedFile> inputs;
+    std::vector<MappedFile> goldens;
+} PrefetchedSample;
+
+int prefetch_file(const std::string &path, std::vector<MappedFile> &files) {
+    MappedFile file;
+
+    if (map_file(path.c_str(), file)) {
+        return FAILURE;
+    }
+    files.push_back(file);
+
+    // Reading one byte per page faults the file in on the prefetch thread
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile char sink = 0;
+
+    for (size_t offset = 0; offset < file.size; offset += page) {
+        sink = sink ^ file.data[offset];
+    }
+
+    return SUCCESS;
+}
+
+PrefetchedSample prefetch_sample(const DatasetSample *sample) {
+    PrefetchedSample prefetched;
+
+    for (const auto &input : sample->inputs) {
+        if (prefetch_file(input, prefetched.inputs)) {
+            prefetched.status = FAILURE;
+            return prefetched;
+        }
+    }
+    for (const auto &golden : sample->goldens) {
+        if (prefetch_file(golden, prefetched.goldens)) {
+            prefetched.status = FAILURE;
+            return prefetched;
+        }
+    }
+
+    return prefetched;
+}
+
+void release_prefetched(PrefetchedSample &prefetched) {
+    for (auto &file : prefetched.inputs) unmap_file(file);
+    for (auto &file : prefetched.goldens) unmap_file(file);
+}
+
+int run_dataset_sweep(const EnnModelId model_id, EnnBufferPtr *buffer_set,
+                      const NumberOfBuffersInfo buffer_info,
+                      const std::vector<DatasetSample> &samples,
+                      const float threshold,
+                      const BenchmarkOptions &benchmark) {
+    const uint32_t n_in_buf = buffer_info.n_in_buf;
+    const uint32_t n_out_buf = buffer_info.n_out_buf;
+    std::vector<uint32_t> output_types(n_out_buf);
+
+    for (uint32_t idx = 0; idx < n_out_buf; idx++) {
+        EnnBufferInfo output_buffer_info;
+        enn::api::EnnGetBufferInfoByIndex(&output_buffer_info, model_id,
+                                          ENN_DIR_OUT, idx);
+        output_types[idx] = output_buffer_info.buffer_type;
+    }
+
+    std::cout << "Dataset Samples: " << samples.size() << std::endl;
+
+    std::vector<int64_t> durations;
+    size_t checked = 0, matched = 0, skipped = 0;
+    size_t exact_layers = 0, snr_layers = 0;
+    double snr_sum = 0, snr_min = INFINITY, cosine_min = INFINITY;
+    double max_abs_error = 0;
+
+    auto sweep_start = std::chrono::high_resolution_clock::now();
+    std::future<PrefetchedSample> next =
+        std::async(std::launch::async, prefetch_sample, &samples[0]);
+
+    for (size_t idx = 0; idx < samples.size(); idx++) {
+        const DatasetSample &sample = samples[idx];
+        PrefetchedSample current = next.get();
+
+        // The next sample's files are read while this one executes
+        if (idx + 1 < samples.size()) {
+            next = std::async(std::launch::async, prefetch_sample,
+                              &samples[idx + 1]);
+        }
+
+        bool loaded = !current.status;
+
+        for (uint32_t layer = 0; loaded && layer < n_in_buf; layer++) {
+            loaded = current.inputs[layer].size == buffer_set[layer]->size;
+        }
+        for (uint32_t layer = 0; loaded && layer < current.goldens.size();
+             layer++) {
+            loaded = current.goldens[layer].size ==
+                     buffer_set[n_in_buf + layer]->size;
+        }
+
+        if (!loaded) {
+            std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                      << "\tSample(" << idx + 1 << ") " << sample.name
+                      << ": Missing files or layer size mismatch, skipped"
+                      << std::endl;
+            release_prefetched(current);
+            skipped++;
+            continue;
+        }
+
+        for (uint32_t layer = 0; layer < n_in_buf; layer++) {
+            memcpy(buffer_set[layer]->va, current.inputs[layer].data,
+                   current.inputs[layer].size);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        if (enn::api::EnnExecuteModel(model_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Execute Model (sample " << idx + 1
+                      << ")" << std::endl;
+            release_prefetched(current);
+            if (next.valid()) {
+                PrefetchedSample pending = next.get();
+                release_prefetched(pending);
+            }
+            return FAILURE;
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        durations.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+                .count());
+
+        bool match = true;
+        std::stringstream mismatches;
+
+        for (uint32_t layer = 0; layer < current.goldens.size(); layer++) {
+            CompareStats stats = compare_buffer(
+                output_types[layer], current.goldens[layer].data,
+                buffer_set[n_in_buf + layer]->va, current.goldens[layer].size,
+                threshold);
+
+            if (std::isinf(stats.snr)) {
+                exact_layers++;
+            } else {
+                snr_sum += stats.snr;
+                snr_layers++;
+            }
+            snr_min = std::min(snr_min, stats.snr);
+            cosine_min = std::min(cosine_min, stats.cosine);
+            max_abs_error = std::max(max_abs_error, stats.max_abs_error);
+
+            if (stats.mismatches) {
+                match = false;
+                mismatches << "-\tLayer(" << layer << ") different indices:"
+                           << stats.mismatches << "  snr value:" << stats.snr
+                           << std::endl;
+            }
+        }
+
+        if (!current.goldens.empty()) {
+            checked++;
+            if (match) matched++;
+        }
+
+        if (!benchmark.quiet) {
+            std::cout << "Sample(" << idx + 1 << ") " << sample.name << ": ";
+            if (current.goldens.empty()) {
+                std::cout << "Executed";
+            } else if (match) {
+                std::cout << SUCCESS_COLOR << "Golden Match" << RESET_COLOR;
+            } else {
+                std::cout << ERROR_COLOR << "Golden Mismatch" << RESET_COLOR;
+            }
+            std::cout << " (" << durations.back() << " microseconds)"
+                      << std::endl
+                      << mismatches.str();
+        }
+
+        release_prefetched(current);
+    }
+
+    auto sweep_end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Dataset Sweep Statistics (" << samples.size()
+              << " samples, " << skipped << " skipped):" << std::endl;
+    if (checked > 0) {
+        std::cout << std::fixed << std::setprecision(2)
+                  << "-\tgolden match:" << matched << "/" << checked << " ("
+                  << 100.0 * matched / checked << "%)" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+        std::cout << std::setprecision(6);
+        std::cout << "-\tsnr min:" << snr_min << "  mean:"
+                  << (snr_layers ? snr_sum / snr_layers : INFINITY) << "  ("
+                  << exact_layers << " bit-exact layers)" << std::endl;
+        std::cout << "-\tcosine similarity min:" << cosine_min
+                  << "  max abs error:" << max_abs_error << std::endl;
+    }
+
+    if (!durations.empty()) {
+        auto wall_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                             sweep_end - sweep_start)
+                             .count();
+        LatencyStats stats = compute_latency_stats(durations);
+        stats.throughput =
+            durations.size() * 1e6 / std::max<int64_t>(wall_time, 1);
+        print_latency_stats(stats);
+
+        if (benchmark.histogram_bins > 0) {
+            print_latency_histogram(durations, stats, benchmark.histogram_bins);
+        }
+    }
+
+    return SUCCESS;
+}
+
+int execute_concurrent(const std::vector<std::string> &model_names,
+                       const int iteration, const BenchmarkOptions &benchmark) {
+    if (enn::api::EnnInitialize()) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Initialize" << std::endl;
+        return FAILURE;
+    }
+
+    std::vector<ConcurrentModel> models(model_names.size());
+    int result = SUCCESS;
+    size_t opened = 0;
+
+    for (; opened < models.size(); opened++) {
+        ConcurrentModel &model = models[opened];
+        model.name = model_names[opened];
+
+        if (enn::api::EnnOpenModel(model.name.c_str(), &model.model_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Open Model(" << model.name << ")"
+                      << std::endl;
+            result = FAILURE;
+            break;
+        }
+        std::cout << "Loaded Model:\n\t" << model.name << "(" << STDOUT_64HEX
+                  << model.model_id << std::dec << ")" << std::endl;
+
+        if (enn::api::EnnAllocateAllBuffers(model.model_id, &model.buffer_set,
+                                            &model.buffer_info)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Allocate Buffers(" << model.name << ")"
+                      << std::endl;
+            enn::api::EnnCloseModel(model.model_id);
+            result = FAILURE;
+            break;
+        }
+    }
+
+    if (!result) {
+        result = run_concurrent_benchmark(models, iteration, benchmark);
+    }
+
+    for (size_t idx = 0; idx < opened; idx++) {
+        const ConcurrentModel &model = models[idx];
+
+        if (enn::api::EnnReleaseBuffers(model.buffer_set,
+                                        model.buffer_info.n_in_buf +
+                                            model.buffer_info.n_out_buf) ||
+            enn::api::EnnCloseModel(model.model_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Close Model(" << model.name << ")"
+                      << std::endl;
+            result = FAILURE;
+        }
+    }
+
+    if (enn::api::EnnDeinitialize()) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Deinitialize" << std::endl;
+        return FAILURE;
+    }
+
+    return result;
+}
+
+int run_concurrent_benchmark(std::vector<ConcurrentModel> &models,
+                             const int iteration,
+                             const BenchmarkOptions &benchmark) {
+    using clock = std::chrono::high_resolution_clock;
+    // Per-iteration lines of several threads would interleave
+    BenchmarkOptions quiet = benchmark;
+    quiet.quiet = true;
+
+    for (auto &model : models) {
+        for (int idx = 0; idx < benchmark.warmup; idx++) {
+            if (enn::api::EnnExecuteModel(model.model_id)) {
+                std::cerr << ERROR_COLOR << "ENN Framework Error:"
+                          << RESET_COLOR << "\tFailed to Execute Model("
+                          << model.name << ", warmup)" << std::endl;
+                return FAILURE;
+            }
+        }
+
+        auto solo_start = clock::now();
+        if (run_sync_loop(model.model_id, iteration, quiet, model.solo)) {
+            return FAILURE;
+        }
+        model.solo_wall_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - solo_start)
+                .count();
+    }
+
+    // Every thread waits for the same start signal
+    std::promise<void> go;
+    std::shared_future<void> start = go.get_future().share();
+    std::vector<int> results(models.size(), SUCCESS);
+    std::vector<std::thread> threads;
+
+    for (size_t idx = 0; idx < models.size(); idx++) {
+        threads.emplace_back([&, idx]() {
+            start.wait();
+            results[idx] = run_sync_loop(models[idx].model_id, iteration,
+                                         quiet, models[idx].concurrent);
+        });
+    }
+
+    auto concurrent_start = clock::now();
+    go.set_value();
+    for (auto &thread : threads) thread.join();
+    auto concurrent_wall_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            clock::now() - concurrent_start)
+            .count();
+
+    if (std::count(results.begin(), results.end(), FAILURE)) {
+        return FAILURE;
+    }
+
+    size_t solo_count = 0, concurrent_count = 0;
+    int64_t solo_wall_time = 0;
+
+    std::cout << "Concurrent Execution Statistics (" << models.size()
+              << " models, microseconds):" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t idx = 0; idx < models.size(); idx++) {
+        const ConcurrentModel &model = models[idx];
+        if (model.solo.empty() || model.concurrent.empty()) continue;
+
+        LatencyStats solo = compute_latency_stats(model.solo);
+        LatencyStats shared = compute_latency_stats(model.concurrent);
+        solo.throughput = model.solo.size() * 1e6 /
+                          std::max<int64_t>(model.solo_wall_time, 1);
+        shared.throughput = model.concurrent.size() * 1e6 /
+                            std::max<int64_t>(concurrent_wall_time, 1);
+
+        std::cout << "Model(" << idx << ") " << model.name << ":" << std::endl;
+        std::cout << "-\tsolo\t\tavg:" << solo.mean << "\tp50:" << solo.p50
+                  << "\tp99:" << solo.p99 << "\tthroughput:" << solo.throughput
+                  << " inferences/sec" << std::endl;
+        std::cout << "-\tconcurrent\tavg:" << shared.mean
+                  << "\tp50:" << shared.p50 << "\tp99:" << shared.p99
+                  << "\tthroughput:" << shared.throughput << " inferences/sec"
+                  << std::endl;
+        std::cout << std::setprecision(2) << "-\tp50 slowdown:"
+                  << static_cast<double>(shared.p50) /
+                         std::max<int64_t>(solo.p50, 1)
+                  << "x" << std::setprecision(1) << std::endl;
+
+        solo_count += model.solo.size();
+        concurrent_count += model.concurrent.size();
+        solo_wall_time += model.solo_wall_time;
+    }
+
+    // Running the models one after the other is the baseline to beat
+    const double solo_throughput =
+        solo_count * 1e6 / std::max<int64_t>(solo_wall_time, 1);
+    const double concurrent_throughput =
+        concurrent_count * 1e6 / std::max<int64_t>(concurrent_wall_time, 1);
+
+    std::cout << "Combined Throughput:" << std::endl;
+    std::cout << "-\tsolo back to back:" << solo_throughput
+              << " inferences/sec" << std::endl;
+    std::cout << "-\tconcurrent:" << concurrent_throughput
+              << " inferences/sec (" << std::setprecision(2)
+              << concurrent_throughput / std::max(solo_throughput, 1e-9)
+              << "x)" << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+
+    return SUCCESS;
+}
+
+// Performance modes of PerfModePreference, in the order they are measured
+const std::vector<std::pair<uint32_t, std::string>> PERF_MODES = {
+    {ENN_PREF_MODE_LOW_POWER, "LOW_POWER"},
+    {ENN_PREF_MODE_BALANCED, "BALANCED"},
+    {ENN_PREF_MODE_PERFORMANCE, "PERFORMANCE"},
+    {ENN_PREF_MODE_BOOST, "BOOST"},
+};
+
+std::string perf_mode_name(const uint32_t perf_mode) {
+    for (const auto &mode : PERF_MODES) {
+        if (mode.first == perf_mode) return mode.second;
+    }
+
+    return std::to_string(perf_mode);
+}
+
+int get_preferences(EnnPreferences &preferences) {
+    if (enn::api::EnnGetPreferencePerfMode(&preferences.perf_mode) ||
+        enn::api::EnnGetPreferenceCoreAffinity(&preferences.core_affinity) ||
+        enn::api::EnnGetPreferencePresetId(&preferences.preset_id) ||
+        enn::api::EnnGetPreferencePerfConfigId(&preferences.perf_config_id) ||
+        enn::api::EnnGetPreferencePriority(&preferences.priority)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Get Preferences" << std::endl;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+int set_preferences(const EnnPreferences &preferences) {
+    if (enn::api::EnnSetPreferencePresetId(preferences.preset_id) ||
+        enn::api::EnnSetPreferencePerfConfigId(preferences.perf_config_id) ||
+        enn::api::EnnSetPreferencePriority(preferences.priority) ||
+        enn::api::EnnSetPreferencePerfMode(preferences.perf_mode) ||
+        enn::api::EnnSetPreferenceCoreAffinity(preferences.core_affinity)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Set Preferences" << std::endl;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+// Opens the model under the preferences currently set and times iteration
+// executions, as a sample app does after ennInitialize() applied its
+// preferences file
+int measure_preferences(const std::string &model_name,
+                        const std::vector<std::string> &inputs,
+                        const bool force_mode, const int iteration,
+                        const BenchmarkOptions &benchmark,
+                        PreferenceResult &result) {
+    EnnModelId model_id;
+    EnnBufferPtr *buffer_set;
+    NumberOfBuffersInfo buffer_info;
+
+    if (enn::api::EnnOpenModel(model_name.c_str(), &model_id)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Open Model" << std::endl;
+        return FAILURE;
+    }
+
+    if (enn::api::EnnAllocateAllBuffers(model_id, &buffer_set, &buffer_info)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Allocate Buffers" << std::endl;
+        enn::api::EnnCloseModel(model_id);
+        return FAILURE;
+    }
+
+    BenchmarkOptions quiet = benchmark;
+    quiet.quiet = true;
+    int status = SUCCESS;
+
+    if (!force_mode && load_inputs(buffer_set, buffer_info, inputs)) {
+        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                  << "\tProblem loading input files" << std::endl;
+        status = FAILURE;
+    }
+
+    for (int idx = 0; status == SUCCESS && idx < benchmark.warmup; idx++) {
+        if (enn::api::EnnExecuteModel(model_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Execute Model (warmup)" << std::endl;
+            status = FAILURE;
+        }
+    }
+
+    if (status == SUCCESS) {
+        std::vector<int64_t> durations;
+        auto start = std::chrono::high_resolution_clock::now();
+
+        status = run_sync_loop(model_id, iteration, quiet, durations);
+        auto wall_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::high_resolution_clock::now() - start)
+                             .count();
+
+        if (status == SUCCESS && !durations.empty()) {
+            result.supported = true;
+            result.stats = compute_latency_stats(durations);
+            result.stats.throughput =
+                durations.size() * 1e6 / std::max<int64_t>(wall_time, 1);
+        }
+    }
 
-int main(int argc, char *argv[]) {
-    std::string model_name;
-    std::vector<std::string> inputs;
-    std::vector<std::string> goldens;
-    int iteration = 1;
-    bool force = false;
-    float threshold = 0.0F;
+    if (enn::api::EnnReleaseBuffers(
+            buffer_set, buffer_info.n_in_buf + buffer_info.n_out_buf) ||
+        enn::api::EnnCloseModel(model_id)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Close Model" << std::endl;
+        status = FAILURE;
+    }
 
-    parse_arguments(argc, argv, model_name, inputs, goldens, iteration, force,
-                    threshold);
+    return status;
+}
 
-    if (inputs.empty() && !force) {
-        std::cerr
-            << "You must provide input data files or use the --force flag."
-            << std::endl;
+int run_preference_sweep(const std::string &model_name,
+                         const std::vector<std::string> &inputs,
+                         const bool force_mode, const int iteration,
+                         const BenchmarkOptions &benchmark) {
+    std::vector<PreferenceResult> results;
+    EnnPreferences original;
+
+    if (get_preferences(original)) return FAILURE;
+
+    for (const auto &mode : PERF_MODES) {
+        for (const auto mask : benchmark.affinity_masks) {
+            PreferenceResult result = {original, false, {}};
+            result.preferences.perf_mode = mode.first;
+            result.preferences.core_affinity = mask;
+
+            std::cout << "Preference: perf mode " << mode.second
+                      << ", core affinity 0x" << std::hex << mask << std::dec
+                      << std::endl;
+
+            // Set before the model is opened, as the sample apps do
+            if (enn::api::EnnSetPreferencePerfMode(mode.first) ||
+                enn::api::EnnSetPreferenceCoreAffinity(mask)) {
+                std::cout << "-\tnot supported, skipped" << std::endl;
+                results.push_back(result);
+                continue;
+            }
+
+            if (measure_preferences(model_name, inputs, force_mode, iteration,
+                                    benchmark, result)) {
+                set_preferences(original);
+                return FAILURE;
+            }
+            results.push_back(result);
+        }
+    }
+
+    // Whatever runs next in this process sees the preferences from before
+    if (set_preferences(original)) return FAILURE;
+
+
+    // Unsupported combinations sink to the bottom of the ranking
+    std::stable_sort(results.begin(), results.end(),
+                     [](const PreferenceResult &a, const PreferenceResult &b) {
+                         if (a.supported != b.supported) return a.supported;
+                         return a.supported && a.stats.mean < b.stats.mean;
+                     });
+
+    std::cout << "Preference Sweep Results (ranked by avg, microseconds):"
+              << std::endl;
+    // STDOUT_64HEX leaves a '0' fill behind
+    std::cout << std::setfill(' ') << std::left;
+    std::cout << std::setw(6) << "rank" << std::setw(14)
+              << "perf mode" << std::setw(10) << "affinity" << std::setw(10)
+              << "avg" << std::setw(8) << "p50" << std::setw(8) << "p99"
+              << "throughput" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t idx = 0; idx < results.size(); idx++) {
+        const PreferenceResult &result = results[idx];
+        std::stringstream affinity;
+        affinity << "0x" << std::hex << result.preferences.core_affinity;
+
+        std::cout << std::setw(6) << idx + 1 << std::setw(14)
+                  << perf_mode_name(result.preferences.perf_mode)
+                  << std::setw(10)
+                  << affinity.str();
+        if (result.supported) {
+            std::cout << std::setw(10) << result.stats.mean << std::setw(8)
+                      << result.stats.p50 << std::setw(8) << result.stats.p99
+                      << result.stats.throughput << " inferences/sec";
+        } else {
+            std::cout << "not supported";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::right;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+
+    if (results.empty() || !results[0].supported) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tNo preference could be measured" << std::endl;
         return FAILURE;
     }
 
-    if (execute_model(model_name, inputs, goldens, force, threshold,
-                      iteration)) {
-        std::cerr << ERROR_COLOR << "[[Failed to Execute Model]]" << RESET_COLOR
-                  << std::endl;
+    return write_preferences(benchmark.preferences_path, model_name,
+                             results[0]);
+}
+
+int write_preferences(const std::string &path, const std::string &model_name,
+                      const PreferenceResult &best) {
+    std::ofstream file(path);
+
+    if (!file) {
+        std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
+                  << "\tCannot open file(" << path << ")" << std::endl;
         return FAILURE;
     }
-    std::cout << SUCCESS_COLOR << "ENN Framework Execute Model Sucess"
-              << RESET_COLOR << std::endl;
+
+    file << "# Fastest preferences of " << model_name << ", "
+         << std::fixed << std::setprecision(1) << best.stats.mean
+         << " microseconds on average" << std::endl;
+    file << "preset_id=" << best.preferences.preset_id << std::endl;
+    file << "perf_config_id=" << best.preferences.perf_config_id << std::endl;
+    file << "priority=" << best.preferences.priority << std::endl;
+    file << "perf_mode=" << best.preferences.perf_mode << std::endl;
+    file << "core_affinity=0x" << std::hex << best.preferences.core_affinity
+         << std::endl;
+
+    if (!file) {
+        std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
+                  << "\tCannot write to file(" << path << ")" << std::endl;
+        return FAILURE;
+    }
+
+    std::cout << "Preferences written to " << path << std::endl;
+
+    return SUCCESS;
 }
 
-int execute_model(const std::string model_name,
-                  const std::vector<std::string> &inputs,
-                  const std::vector<std::string> &goldens,
-                  const bool force_mode, const float threshold,
-                  const int iteration) {
+int profile_lifecycle(const std::string model_name,
+                      const std::vector<std::string> &inputs,
+                      const bool force_mode, const int iteration,
+                      const BenchmarkOptions &benchmark) {
+    using clock = std::chrono::high_resolution_clock;
+    // Steps in the order they run, with their duration in microseconds
+    std::vector<std::pair<std::string, int64_t>> steps;
+    auto start = clock::now();
+    auto end_step = [&](const std::string &step) {
+        auto end = clock::now();
+        steps.emplace_back(
+            step, std::chrono::duration_cast<std::chrono::microseconds>(
+                      end - start)
+                      .count());
+        start = end;
+    };
+
     if (enn::api::EnnInitialize()) {
         std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
                   << "\tFailed to Initialize" << std::endl;
         return FAILURE;
     }
+    end_step("EnnInitialize");
 
     EnnModelId model_id;
 
@@ -57,10 +1056,11 @@ int execute_model(const std::string model_name,
         std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
                   << "\tFailed to Open Model" << std::endl;
         return FAILURE;
-    } else {
-        std::cout << "Loaded Model:\n\t" << model_name << "(" << STDOUT_64HEX
-                  << model_id << std::dec << ")" << std::endl;
     }
+    end_step("EnnOpenModel");
+    std::cout << "Loaded Model:\n\t" << model_name << "(" << STDOUT_64HEX
+              << model_id << std::dec << ")" << std::endl;
+    start = clock::now();
 
     EnnBufferPtr *buffer_set;
     NumberOfBuffersInfo buffer_info;
@@ -70,9 +1070,7 @@ int execute_model(const std::string model_name,
                   << "\tFailed to Allocate Buffers" << std::endl;
         return FAILURE;
     }
-
-    uint32_t n_in_buf = buffer_info.n_in_buf;
-    uint32_t n_out_buf = buffer_info.n_out_buf;
+    end_step("EnnAllocateAllBuffers");
 
     if (!force_mode) {
         if (load_inputs(buffer_set, buffer_info, inputs)) {
@@ -80,11 +1078,158 @@ int execute_model(const std::string model_name,
                       << "\tProblem loading input files" << std::endl;
             return FAILURE;
         }
+        end_step("load inputs");
+    }
+
+    if (enn::api::EnnExecuteModel(model_id)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Execute Model" << std::endl;
+        return FAILURE;
+    }
+    end_step("first inference");
+
+    // Steps up to here are what an app waits for before its first result
+    int64_t cold_start = 0;
+    for (const auto &step : steps) cold_start += step.second;
+
+    std::vector<int64_t> durations;
+
+    if (run_sync_loop(model_id, iteration, benchmark, durations)) {
+        return FAILURE;
+    }
+    start = clock::now();
+
+    if (enn::api::EnnReleaseBuffers(
+            buffer_set, buffer_info.n_in_buf + buffer_info.n_out_buf)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Release Buffers" << std::endl;
+        return FAILURE;
+    }
+    end_step("EnnReleaseBuffers");
+
+    if (enn::api::EnnCloseModel(model_id)) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Close Model" << std::endl;
+        return FAILURE;
+    }
+    end_step("EnnCloseModel");
+
+    if (benchmark.compare_open > 0 &&
+        compare_open_latency(model_name, benchmark.compare_open)) {
+        return FAILURE;
+    }
+    start = clock::now();
+
+    if (enn::api::EnnDeinitialize()) {
+        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                  << "\tFailed to Deinitialize" << std::endl;
+        return FAILURE;
+    }
+    end_step("EnnDeinitialize");
+
+    std::cout << "Model Lifecycle Profile (microseconds):" << std::endl;
+    std::cout << std::setfill(' ') << std::left << std::fixed
+              << std::setprecision(1);
+    for (const auto &step : steps) {
+        std::cout << "-\t" << std::setw(24) << step.first << step.second
+                  << std::endl;
+        if (step.first != "first inference") continue;
+
+        std::cout << "-\t" << std::setw(24) << "cold start total"
+                  << cold_start << std::endl;
+        if (!durations.empty()) {
+            LatencyStats stats = compute_latency_stats(durations);
+            std::cout << "-\t" << std::setw(24) << "steady-state inference"
+                      << "avg:" << stats.mean << "\tp50:" << stats.p50
+                      << "\tp99:" << stats.p99 << " (" << stats.count
+                      << " iterations)" << std::endl;
+        }
+    }
+    std::cout << std::right;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+
+    return SUCCESS;
+}
+
+int compare_open_latency(const std::string &model_name, const int repeats) {
+    using clock = std::chrono::high_resolution_clock;
+    MappedFile model;
+
+    if (map_file(model_name.c_str(), model)) {
+        return FAILURE;
+    }
+    if (model.size > UINT32_MAX) {
+        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                  << "\tModel is too large to open from memory" << std::endl;
+        unmap_file(model);
+        return FAILURE;
+    }
+
+    std::vector<int64_t> from_file, from_memory;
+
+    // Alternating keeps both functions under the same cache and clock state
+    for (int idx = 0; idx < repeats; idx++) {
+        for (int from_mem = 0; from_mem < 2; from_mem++) {
+            EnnModelId model_id;
+            auto start = clock::now();
+            EnnReturn result =
+                from_mem ? enn::api::EnnOpenModelFromMemory(
+                               model.data, static_cast<uint32_t>(model.size),
+                               &model_id)
+                         : enn::api::EnnOpenModel(model_name.c_str(),
+                                                  &model_id);
+            auto end = clock::now();
+
+            if (result || enn::api::EnnCloseModel(model_id)) {
+                std::cerr << ERROR_COLOR << "ENN Framework Error:"
+                          << RESET_COLOR << "\tFailed to Open Model"
+                          << (from_mem ? " from memory" : "") << std::endl;
+                unmap_file(model);
+                return FAILURE;
+            }
+
+            auto duration =
+                std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                      start)
+                    .count();
+            (from_mem ? from_memory : from_file).push_back(duration);
+        }
     }
+    unmap_file(model);
+
+    LatencyStats file_stats = compute_latency_stats(from_file);
+    LatencyStats memory_stats = compute_latency_stats(from_memory);
+
+    std::cout << "Model Open Comparison (" << repeats
+              << " opens each, microseconds):" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "-\tEnnOpenModel            avg:" << file_stats.mean
+              << "\tmin:" << file_stats.min << "\tp50:" << file_stats.p50
+              << "\tmax:" << file_stats.max << std::endl;
+    std::cout << "-\tEnnOpenModelFromMemory  avg:" << memory_stats.mean
+              << "\tmin:" << memory_stats.min << "\tp50:" << memory_stats.p50
+              << "\tmax:" << memory_stats.max << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
 
-    auto total_duration = 0;
+    return SUCCESS;
+}
+
+int run_sync_loop(const EnnModelId model_id, const int iteration,
+                  const BenchmarkOptions &benchmark,
+                  std::vector<int64_t> &durations) {
+    auto bench_start = std::chrono::high_resolution_clock::now();
+
+    for (int idx = 1;; idx++) {
+        if (benchmark.duration_sec > 0) {
+            std::chrono::duration<double> elapsed =
+                std::chrono::high_resolution_clock::now() - bench_start;
+            if (elapsed.count() >= benchmark.duration_sec) break;
+        } else if (idx > iteration) {
+            break;
+        }
 
-    for (int idx = 1; idx <= iteration; idx++) {
         auto start = std::chrono::high_resolution_clock::now();
 
         if (enn::api::EnnExecuteModel(model_id)) {
@@ -97,100 +1242,520 @@ int execute_model(const std::string model_name,
         auto duration =
             (std::chrono::duration_cast<std::chrono::microseconds>(end - start))
                 .count();
-        std::cout << "Model Execution Time (" << idx << "): " << duration
-                  << " microseconds" << std::endl;
-        total_duration += duration;
+        if (!benchmark.quiet) {
+            std::cout << "Model Execution Time (" << idx << "): " << duration
+                      << " microseconds" << std::endl;
+        }
+        durations.push_back(duration);
     }
 
-    std::cout << "Avg. Model Execution Time: " << (total_duration / iteration)
-              << " microseconds" << std::endl;
+    return SUCCESS;
+}
 
-    if (!force_mode) {
-        process_outputs(model_id, buffer_set, buffer_info, goldens, threshold);
+int run_async_pipeline(const EnnModelId model_id, const int n_sessions,
+                       const int iteration, const BenchmarkOptions &benchmark,
+                       std::vector<int64_t> &durations) {
+    using clock = std::chrono::high_resolution_clock;
+    std::vector<clock::time_point> submitted(n_sessions);
+    std::vector<bool> in_flight(n_sessions, false);
+    auto bench_start = clock::now();
+    int issued = 0;
+    int result = SUCCESS;
+
+    auto keep_issuing = [&]() {
+        if (benchmark.duration_sec > 0) {
+            std::chrono::duration<double> elapsed = clock::now() - bench_start;
+            return elapsed.count() < benchmark.duration_sec;
+        }
+        return issued < iteration;
+    };
+
+    for (int session_id = 0; session_id < n_sessions && keep_issuing();
+         session_id++) {
+        submitted[session_id] = clock::now();
+        if (enn::api::EnnExecuteModelAsync(model_id, session_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Execute Model Async (session "
+                      << session_id << ")" << std::endl;
+            result = FAILURE;
+            break;
+        }
+        in_flight[session_id] = true;
+        issued++;
     }
 
-    if (enn::api::EnnReleaseBuffers(buffer_set, n_in_buf + n_out_buf)) {
-        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
-                  << "\tFailed to Release Buffers" << std::endl;
-        return FAILURE;
+    // Collect results in submission order (round-robin over the sessions) and
+    // resubmit each session as soon as its result is collected
+    for (int session_id = 0; result == SUCCESS;
+         session_id = (session_id + 1) % n_sessions) {
+        if (!in_flight[session_id]) {
+            if (std::find(in_flight.begin(), in_flight.end(), true) ==
+                in_flight.end()) {
+                break;
+            }
+            continue;
+        }
+
+        if (enn::api::EnnExecuteModelWait(model_id, session_id)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Wait Model Execution (session "
+                      << session_id << ")" << std::endl;
+            in_flight[session_id] = false;
+            result = FAILURE;
+            break;
+        }
+        in_flight[session_id] = false;
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                            clock::now() - submitted[session_id])
+                            .count();
+        durations.push_back(duration);
+        if (!benchmark.quiet) {
+            std::cout << "Model Execution Time (" << durations.size()
+                      << ", session " << session_id << "): " << duration
+                      << " microseconds" << std::endl;
+        }
+
+        if (keep_issuing()) {
+            submitted[session_id] = clock::now();
+            if (enn::api::EnnExecuteModelAsync(model_id, session_id)) {
+                std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                          << "\tFailed to Execute Model Async (session "
+                          << session_id << ")" << std::endl;
+                result = FAILURE;
+                break;
+            }
+            in_flight[session_id] = true;
+            issued++;
+        }
     }
 
-    if (enn::api::EnnCloseModel(model_id)) {
-        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
-                  << "\tFailed to Close Model" << std::endl;
+    // Drain whatever is still running before the buffers are released
+    for (int session_id = 0; session_id < n_sessions; session_id++) {
+        if (in_flight[session_id]) {
+            enn::api::EnnExecuteModelWait(model_id, session_id);
+        }
+    }
+
+    return result;
+}
+
+void release_sessions(const std::vector<EnnBufferPtr *> &sessions,
+                      const NumberOfBuffersInfo buffer_info) {
+    for (auto session_buffer_set : sessions) {
+        if (enn::api::EnnReleaseBuffers(
+                session_buffer_set, buffer_info.n_in_buf + buffer_info.n_out_buf)) {
+            std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
+                      << "\tFailed to Release Buffers" << std::endl;
+        }
+    }
+}
+
+LatencyStats compute_latency_stats(const std::vector<int64_t> &durations) {
+    LatencyStats stats = {};
+    std::vector<int64_t> sorted(durations);
+    std::sort(sorted.begin(), sorted.end());
+
+    stats.count = sorted.size();
+    if (stats.count == 0) return stats;
+
+    double sum = 0;
+    for (auto duration : sorted) sum += duration;
+    stats.mean = sum / stats.count;
+
+    double variance = 0;
+    for (auto duration : sorted) {
+        variance += (duration - stats.mean) * (duration - stats.mean);
+    }
+    stats.stddev = std::sqrt(variance / stats.count);
+
+    // Nearest-rank percentiles over the sorted samples
+    auto percentile = [&sorted](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    };
+
+    stats.min = sorted.front();
+    stats.max = sorted.back();
+    stats.p50 = percentile(50);
+    stats.p90 = percentile(90);
+    stats.p99 = percentile(99);
+
+    return stats;
+}
+
+void print_latency_stats(const LatencyStats &stats) {
+    std::cout << "Model Execution Statistics (" << stats.count
+              << " iterations, microseconds):" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "-\tavg:" << stats.mean << "\tstddev:" << stats.stddev
+              << std::endl;
+    std::cout << "-\tmin:" << stats.min << "\tmax:" << stats.max << std::endl;
+    std::cout << "-\tp50:" << stats.p50 << "\tp90:" << stats.p90
+              << "\tp99:" << stats.p99 << std::endl;
+    std::cout << "-\tthroughput:" << stats.throughput << " inferences/sec"
+              << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+std::vector<int> build_latency_histogram(const std::vector<int64_t> &durations,
+                                         const LatencyStats &stats,
+                                         const int bins) {
+    std::vector<int> histogram(bins, 0);
+    double width = static_cast<double>(stats.max - stats.min + 1) / bins;
+
+    for (auto duration : durations) {
+        int bin = static_cast<int>((duration - stats.min) / width);
+        histogram[std::min(bin, bins - 1)]++;
+    }
+
+    return histogram;
+}
+
+void print_latency_histogram(const std::vector<int64_t> &durations,
+                             const LatencyStats &stats, const int bins) {
+    const int bar_width = 40;
+    std::vector<int> histogram = build_latency_histogram(durations, stats, bins);
+    double width = static_cast<double>(stats.max - stats.min + 1) / bins;
+    int peak = *std::max_element(histogram.begin(), histogram.end());
+
+    std::cout << "Latency Histogram (microseconds):" << std::endl;
+    std::cout << std::setfill(' ');
+    for (int bin = 0; bin < bins; bin++) {
+        int64_t lower = stats.min + static_cast<int64_t>(bin * width);
+        int64_t upper = stats.min + static_cast<int64_t>((bin + 1) * width);
+        int bar = peak ? histogram[bin] * bar_width / peak : 0;
+
+        std::cout << "-\t[" << std::setw(8) << lower << ", " << std::setw(8)
+                  << upper << ") " << std::setw(6) << histogram[bin] << " "
+                  << std::string(bar, '#') << std::endl;
+    }
+}
+
+std::string escape_json_string(const std::string &value) {
+    std::ostringstream escaped;
+
+    for (const char ch : value) {
+        switch (ch) {
+            case '"': escaped << "\\\""; break;
+            case '\\': escaped << "\\\\"; break;
+            case '\b': escaped << "\\b"; break;
+            case '\f': escaped << "\\f"; break;
+            case '\n': escaped << "\\n"; break;
+            case '\r': escaped << "\\r"; break;
+            case '\t': escaped << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    escaped << "\\u" << std::hex << std::setw(4)
+                            << std::setfill('0') << static_cast<int>(ch)
+                            << std::dec << std::setfill(' ');
+                } else {
+                    escaped << ch;
+                }
+        }
+    }
+
+    return escaped.str();
+}
+
+std::string quote_csv_field(const std::string &value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) return value;
+
+    std::string quoted = "\"";
+    for (const char ch : value) {
+        if (ch == '"') quoted += '"';
+        quoted += ch;
+    }
+
+    return quoted + "\"";
+}
+
+int write_benchmark_report(const std::string &model_name,
+                           const BenchmarkOptions &benchmark,
+                           const std::vector<int64_t> &durations,
+                           const LatencyStats &stats) {
+    std::string path = benchmark.report_path;
+    if (path.empty()) path = "benchmark_report." + benchmark.report_format;
+
+    std::ofstream report(path);
+    if (!report) {
+        std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
+                  << "\tCannot open file(" << path << ")" << std::endl;
         return FAILURE;
     }
 
-    if (enn::api::EnnDeinitialize()) {
-        std::cerr << ERROR_COLOR << "ENN Framework Error:" << RESET_COLOR
-                  << "\tFailed to Deinitialize" << std::endl;
+    if (benchmark.report_format == "csv") {
+        report << "model,warmup,iterations,inflight,avg_us,stddev_us,min_us,"
+                  "max_us,p50_us,p90_us,p99_us,throughput\n";
+        report << quote_csv_field(model_name) << "," << benchmark.warmup
+               << "," << stats.count << ","
+               << (benchmark.async_mode ? benchmark.inflight : 1) << ","
+               << stats.mean << "," << stats.stddev << "," << stats.min << ","
+               << stats.max << "," << stats.p50 << "," << stats.p90 << ","
+               << stats.p99 << "," << stats.throughput << "\n";
+    } else {
+        int bins = std::max(benchmark.histogram_bins, 1);
+        std::vector<int> histogram =
+            build_latency_histogram(durations, stats, bins);
+        double width = static_cast<double>(stats.max - stats.min + 1) / bins;
+
+        report << "{\n";
+        report << "  \"model\": \"" << escape_json_string(model_name)
+               << "\",\n";
+        report << "  \"warmup\": " << benchmark.warmup << ",\n";
+        report << "  \"iterations\": " << stats.count << ",\n";
+        report << "  \"inflight\": "
+               << (benchmark.async_mode ? benchmark.inflight : 1) << ",\n";
+        report << "  \"throughput\": " << stats.throughput << ",\n";
+        report << "  \"latency_us\": {\"avg\": " << stats.mean
+               << ", \"stddev\": " << stats.stddev << ", \"min\": " << stats.min
+               << ", \"max\": " << stats.max << ", \"p50\": " << stats.p50
+               << ", \"p90\": " << stats.p90 << ", \"p99\": " << stats.p99
+               << "},\n";
+        report << "  \"histogram\": [";
+        for (int bin = 0; bin < bins; bin++) {
+            report << (bin ? ", " : "") << "{\"lower_us\": "
+                   << stats.min + static_cast<int64_t>(bin * width)
+                   << ", \"upper_us\": "
+                   << stats.min + static_cast<int64_t>((bin + 1) * width)
+                   << ", \"count\": " << histogram[bin] << "}";
+        }
+        report << "],\n";
+        report << "  \"samples_us\": [";
+        for (size_t idx = 0; idx < durations.size(); idx++) {
+            report << (idx ? ", " : "") << durations[idx];
+        }
+        report << "]\n";
+        report << "}\n";
+    }
+
+    if (!report) {
+        std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
+                  << "\tCannot write to file(" << path << ")" << std::endl;
         return FAILURE;
     }
 
+    std::cout << "Benchmark report written to " << path << std::endl;
+
     return SUCCESS;
 }
 
+// Running sums of compare_outputs(), merged into CompareStats at the end
+typedef struct _CompareSums {
+    size_t mismatches = 0;
+    double signal = 0;   // sum of golden^2
+    double noise = 0;    // sum of (output - golden)^2
+    double dot = 0;      // sum of output * golden
+    double output = 0;   // sum of output^2
+    double max_abs_error = 0;
+} CompareSums;
+
 template <typename T>
-int compare_data(T *data1, T *data2, int size, T threshold) {
-    int diff = 0;
-    for (int idx = 0; idx < size; idx++) {
-        if (std::abs(data1[idx] - data2[idx]) > threshold) {
-            diff++;
-        }
+inline double element_value(const T value) {
+    return static_cast<double>(value);
+}
+
+inline double element_value(const Half value) {
+    const uint32_t sign = (value.bits >> 15) & 0x1;
+    const uint32_t exponent = (value.bits >> 10) & 0x1F;
+    const uint32_t mantissa = value.bits & 0x3FF;
+    double magnitude;
+
+    if (exponent == 0) {
+        magnitude = std::ldexp(static_cast<double>(mantissa), -24);
+    } else if (exponent == 0x1F) {
+        magnitude = mantissa ? NAN : INFINITY;
+    } else {
+        magnitude = std::ldexp(static_cast<double>(mantissa | 0x400),
+                               static_cast<int>(exponent) - 25);
     }
 
-    return diff;
+    return sign ? -magnitude : magnitude;
 }
 
 template <typename T>
-float calculate_snr(T *control_data, T *test_data, int size) {
-    float signal_power = 0;
-    float noise_power = 0;
+void accumulate_compare(const T *control, const T *test, const size_t begin,
+                        const size_t end, const double threshold,
+                        CompareSums &sums) {
+    for (size_t idx = begin; idx < end; idx++) {
+        const double golden = element_value(control[idx]);
+        const double output = element_value(test[idx]);
+        const double error = output - golden;
+        const double abs_error = std::abs(error);
+
+        // NaN outputs count as mismatches and propagate to the max error
+        if (!(abs_error <= threshold)) sums.mismatches++;
+        if (abs_error > sums.max_abs_error || std::isnan(abs_error)) {
+            sums.max_abs_error = abs_error;
+        }
+
+        sums.signal += golden * golden;
+        sums.noise += error * error;
+        sums.dot += output * golden;
+        sums.output += output * output;
+    }
+}
 
-    for (int idx = 0; idx < size; idx++) {
-        signal_power += control_data[idx] * control_data[idx];
-        noise_power += (test_data[idx] - control_data[idx]) *
-                       (test_data[idx] - control_data[idx]);
+#if defined(__ARM_NEON) && defined(__aarch64__)
+// Compares 4 floats per step, returns the index left for the scalar tail.
+// Elements are widened to double before the subtraction, so that the errors,
+// mismatches and sums match accumulate_compare() rather than float math.
+size_t accumulate_compare_neon(const float *control, const float *test,
+                               const size_t count, const double threshold,
+                               CompareSums &sums) {
+    const float64x2_t limit = vdupq_n_f64(threshold);
+    float64x2_t signal = vdupq_n_f64(0);
+    float64x2_t noise = vdupq_n_f64(0);
+    float64x2_t dot = vdupq_n_f64(0);
+    float64x2_t output = vdupq_n_f64(0);
+    float64x2_t max_error = vdupq_n_f64(0);
+    uint64x2_t mismatches = vdupq_n_u64(0);
+    size_t idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        const float32x4_t c = vld1q_f32(control + idx);
+        const float32x4_t t = vld1q_f32(test + idx);
+        const float64x2_t halves[2][2] = {
+            {vcvt_f64_f32(vget_low_f32(c)), vcvt_f64_f32(vget_low_f32(t))},
+            {vcvt_high_f64_f32(c), vcvt_high_f64_f32(t)}};
+
+        for (const auto &half : halves) {
+            const float64x2_t golden = half[0];
+            const float64x2_t value = half[1];
+            const float64x2_t error = vsubq_f64(value, golden);
+            const float64x2_t abs_error = vabsq_f64(error);
+
+            // A false comparison is all ones, subtracting it counts one
+            mismatches = vsubq_u64(mismatches,
+                                   vreinterpretq_u64_u32(vmvnq_u32(
+                                       vreinterpretq_u32_u64(
+                                           vcleq_f64(abs_error, limit)))));
+            max_error = vmaxq_f64(max_error, abs_error);
+
+            signal = vfmaq_f64(signal, golden, golden);
+            noise = vfmaq_f64(noise, error, error);
+            dot = vfmaq_f64(dot, value, golden);
+            output = vfmaq_f64(output, value, value);
+        }
     }
 
-    if (noise_power == 0) return INFINITY;
+    sums.mismatches += vaddvq_u64(mismatches);
+    sums.signal += vaddvq_f64(signal);
+    sums.noise += vaddvq_f64(noise);
+    sums.dot += vaddvq_f64(dot);
+    sums.output += vaddvq_f64(output);
+    sums.max_abs_error = vmaxvq_f64(max_error);
+
+    return idx;
+}
+#endif
+
+template <typename T>
+CompareStats compare_outputs(const T *control, const T *test,
+                             const size_t count, const double threshold) {
+    CompareSums sums;
+    size_t idx = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    if (std::is_same<T, float>::value) {
+        idx = accumulate_compare_neon(
+            reinterpret_cast<const float *>(control),
+            reinterpret_cast<const float *>(test), count, threshold, sums);
+    }
+#endif
+    accumulate_compare(control, test, idx, count, threshold, sums);
+
+    CompareStats stats;
+    stats.count = count;
+    stats.mismatches = sums.mismatches;
+    stats.max_abs_error = sums.max_abs_error;
+    stats.rmse = count ? std::sqrt(sums.noise / count) : 0;
+    stats.snr =
+        sums.noise == 0 ? INFINITY : 10 * log10(sums.signal / sums.noise);
+    if (sums.signal == 0 || sums.output == 0) {
+        // Two all-zero tensors are identical, one alone has no direction
+        stats.cosine = sums.signal == sums.output ? 1 : 0;
+    } else {
+        stats.cosine = sums.dot / std::sqrt(sums.signal * sums.output);
+    }
 
-    return 10 * log10(signal_power / noise_power);
+    return stats;
 }
 
-int copy_file_to_mem(const char *filename, char *dst) {
-    FILE *f = fopen(filename, "rb");
+int map_file(const char *filename, MappedFile &file) {
+    file.data = nullptr;
+    file.size = 0;
 
-    if (!f) {
+    int fd = open(filename, O_RDONLY);
+
+    if (fd < 0) {
         std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
                   << "\tCannot open file(" << filename << ")" << std::endl;
-        return -1;
+        return FAILURE;
     }
 
-    size_t size;
-
-    fseek(f, 0, SEEK_END);
-    size = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    struct stat st;
 
-    if (size < 0) {
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode)) {
         std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
                   << "\tInvalid file size" << std::endl;
-        return -1;
+        close(fd);
+        return FAILURE;
     }
 
-    if (size != fread(dst, 1, size, f)) {
-        std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
-                  << "\tCannot read file" << std::endl;
+    file.size = static_cast<size_t>(st.st_size);
+
+    // mmap() rejects empty mappings, an empty file is left unmapped
+    if (file.size > 0) {
+        void *data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
+                      << "\tCannot map file(" << filename << ")" << std::endl;
+            close(fd);
+            file.size = 0;
+            return FAILURE;
+        }
+        // Both users read the file once from front to back
+        madvise(data, file.size, MADV_SEQUENTIAL);
+        file.data = reinterpret_cast<const char *>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+
+    return SUCCESS;
+}
+
+void unmap_file(MappedFile &file) {
+    if (file.data) {
+        munmap(const_cast<char *>(file.data), file.size);
+    }
+    file.data = nullptr;
+    file.size = 0;
+}
+
+int64_t copy_file_to_mem(const char *filename, char *dst,
+                         const size_t dst_size) {
+    MappedFile file;
+
+    if (map_file(filename, file)) {
         return -1;
     }
 
-    fclose(f);
+    const int64_t size = static_cast<int64_t>(file.size);
+
+    if (file.size == dst_size) {
+        memcpy(dst, file.data, file.size);
+    }
+    unmap_file(file);
 
     return size;
 }
 
-int copy_mem_to_file(const char *src, const char *filename, const int size) {
+int copy_mem_to_file(const char *src, const char *filename,
+                     const size_t size) {
     FILE *f = fopen(filename, "wb");
 
     if (!f) {
@@ -202,10 +1767,15 @@ int copy_mem_to_file(const char *src, const char *filename, const int size) {
     if (fwrite(src, 1, size, f) != size) {
         std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
                   << "\tCannot write to file" << std::endl;
+        fclose(f);
         return FAILURE;
     }
 
-    fclose(f);
+    if (fclose(f)) {
+        std::cerr << ERROR_COLOR << "OUTPUT Error:" << RESET_COLOR
+                  << "\tCannot write to file" << std::endl;
+        return FAILURE;
+    }
 
     return SUCCESS;
 }
@@ -223,9 +1793,10 @@ int load_inputs(const EnnBufferPtr *buffer_set,
         return FAILURE;
     }
 
-    for (int idx = 0; idx < n_in_buf; idx++) {
-        int load_size = copy_file_to_mem(
-            inputs[idx].c_str(), reinterpret_cast<char *>(buffer_set[idx]->va));
+    for (uint32_t idx = 0; idx < n_in_buf; idx++) {
+        int64_t load_size = copy_file_to_mem(
+            inputs[idx].c_str(), reinterpret_cast<char *>(buffer_set[idx]->va),
+            buffer_set[idx]->size);
         if (load_size < 0) {
             std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
                       << "\tLayer Index " << idx
@@ -233,7 +1804,7 @@ int load_inputs(const EnnBufferPtr *buffer_set,
                       << std::endl;
             return FAILURE;
         }
-        if (load_size != (buffer_set[idx]->size)) {
+        if (load_size != static_cast<int64_t>(buffer_set[idx]->size)) {
             std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
                       << "\tLayer Index " << idx
                       << ": Input layer size and input data size mismatch"
@@ -260,28 +1831,26 @@ int process_outputs(const EnnModelId model_id, EnnBufferPtr *buffer_set,
 
     EnnBufferInfo output_buffer_info;
 
-    for (int idx = 0; idx < n_out_buf; idx++) {
+    for (uint32_t idx = 0; idx < n_out_buf; idx++) {
         int layer_idx = n_in_buf + idx;
 
         if (golden_match) {
-            int golden_size = buffer_set[layer_idx]->size;
-            char *golden = new char[golden_size];
+            // Goldens are compared straight from the page cache
+            MappedFile golden;
 
-            int load_size = copy_file_to_mem(goldens[idx].c_str(), golden);
-            if (load_size < 0) {
+            if (map_file(goldens[idx].c_str(), golden)) {
                 std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
                           << "\tLayer Index " << idx
                           << ": Problem loading golden data file to memory"
                           << std::endl;
-                delete[] golden;
                 return FAILURE;
             }
-            if (load_size != golden_size) {
+            if (golden.size != buffer_set[layer_idx]->size) {
                 std::cerr << ERROR_COLOR << "INPUT Error:" << RESET_COLOR
                           << "\tLayer Index " << idx
                           << ": Output layer size and golden data size mismatch"
                           << std::endl;
-                delete[] golden;
+                unmap_file(golden);
                 return FAILURE;
             }
 
@@ -290,22 +1859,13 @@ int process_outputs(const EnnModelId model_id, EnnBufferPtr *buffer_set,
             enn::api::EnnGetBufferInfoByIndex(&output_buffer_info, model_id,
                                               ENN_DIR_OUT, idx);
 
-            switch (output_buffer_info.buffer_type) {
-                case BufferType_FLOAT32:
-                    golden_matching<float>(golden, buffer_set[layer_idx]->va,
-                                           buffer_set[layer_idx]->size,
-                                           threshold);
-                    break;
-                case BufferType_UINT8:
-                    golden_matching<uint8_t>(golden, buffer_set[layer_idx]->va,
-                                             buffer_set[layer_idx]->size,
-                                             threshold);
-                    break;
-            }
-            delete[] golden;
+            golden_matching(output_buffer_info.buffer_type, golden.data,
+                            buffer_set[layer_idx]->va,
+                            buffer_set[layer_idx]->size, threshold);
+            unmap_file(golden);
         } else {
             char filename[256];
-            snprintf(filename, sizeof(filename), "output%d.bin", idx);
+            snprintf(filename, sizeof(filename), "output%u.bin", idx);
             if (copy_mem_to_file(
                     reinterpret_cast<char *>(buffer_set[layer_idx]->va),
                     filename, (buffer_set[layer_idx]->size))) {
@@ -319,41 +1879,107 @@ int process_outputs(const EnnModelId model_id, EnnBufferPtr *buffer_set,
     return SUCCESS;
 }
 
-template <typename T>
-void golden_matching(void *control, void *test, int size, float threshold) {
-    int diff = compare_data<T>(reinterpret_cast<T *>(test),
-                               reinterpret_cast<T *>(control), size / sizeof(T),
-                               threshold);
+CompareStats compare_buffer(const uint32_t type, const void *control,
+                            const void *test, const size_t size,
+                            const float threshold) {
+    switch (type) {
+        case BufferType_FLOAT32:
+        case BufferType_COMPLEX64:
+            return compare_outputs(reinterpret_cast<const float *>(control),
+                                   reinterpret_cast<const float *>(test),
+                                   size / sizeof(float), threshold);
+        case BufferType_FLOAT16:
+            return compare_outputs(reinterpret_cast<const Half *>(control),
+                                   reinterpret_cast<const Half *>(test),
+                                   size / sizeof(Half), threshold);
+        case BufferType_FLOAT64:
+        case BufferType_COMPLEX128:
+            return compare_outputs(reinterpret_cast<const double *>(control),
+                                   reinterpret_cast<const double *>(test),
+                                   size / sizeof(double), threshold);
+        case BufferType_INT8:
+            return compare_outputs(reinterpret_cast<const int8_t *>(control),
+                                   reinterpret_cast<const int8_t *>(test),
+                                   size / sizeof(int8_t), threshold);
+        case BufferType_INT16:
+            return compare_outputs(reinterpret_cast<const int16_t *>(control),
+                                   reinterpret_cast<const int16_t *>(test),
+                                   size / sizeof(int16_t), threshold);
+        case BufferType_INT32:
+            return compare_outputs(reinterpret_cast<const int32_t *>(control),
+                                   reinterpret_cast<const int32_t *>(test),
+                                   size / sizeof(int32_t), threshold);
+        case BufferType_INT64:
+            return compare_outputs(reinterpret_cast<const int64_t *>(control),
+                                   reinterpret_cast<const int64_t *>(test),
+                                   size / sizeof(int64_t), threshold);
+        case BufferType_UINT32:
+            return compare_outputs(reinterpret_cast<const uint32_t *>(control),
+                                   reinterpret_cast<const uint32_t *>(test),
+                                   size / sizeof(uint32_t), threshold);
+        case BufferType_UINT64:
+            return compare_outputs(reinterpret_cast<const uint64_t *>(control),
+                                   reinterpret_cast<const uint64_t *>(test),
+                                   size / sizeof(uint64_t), threshold);
+        default:
+            // UINT8, BOOL and opaque buffers are compared byte by byte
+            return compare_outputs(reinterpret_cast<const uint8_t *>(control),
+                                   reinterpret_cast<const uint8_t *>(test),
+                                   size, threshold);
+    }
+}
 
-    float snr =
-        calculate_snr<T>(reinterpret_cast<T *>(test),
-                         reinterpret_cast<T *>(control), size / sizeof(T));
+void golden_matching(const uint32_t type, const void *control,
+                     const void *test, const size_t size,
+                     const float threshold) {
+    CompareStats stats = compare_buffer(type, control, test, size, threshold);
 
-    if (diff == 0) {
+    if (stats.mismatches == 0) {
         std::cout << SUCCESS_COLOR << "Golden Match" << RESET_COLOR
                   << std::endl;
     } else {
         std::cout << ERROR_COLOR << "Golden Mismatch" << RESET_COLOR
                   << std::endl;
         std::cout << "-\t"
-                  << "different indices:" << diff << std::endl;
+                  << "different indices:" << stats.mismatches << std::endl;
     }
-    std::cout << "-\tsnr value:" << snr << std::endl;
+    std::cout << "-\tsnr value:" << stats.snr << std::endl;
+    std::cout << "-\tmax abs error:" << stats.max_abs_error
+              << "  rmse:" << stats.rmse
+              << "  cosine similarity:" << stats.cosine << std::endl;
 }
 
-void parse_arguments(int argc, char **argv, std::string &model_name,
+void parse_arguments(int argc, char **argv,
+                     std::vector<std::string> &model_names,
                      std::vector<std::string> &inputs,
                      std::vector<std::string> &goldens, int &iteration,
-                     bool &force, float &threshold) {
+                     bool &force, float &threshold,
+                     BenchmarkOptions &benchmark, DatasetOptions &dataset) {
     CLI::App app("ENN SDK NNC Model Tester");
 
-    app.add_option("--model", model_name, "Name of the model to execute")
+    app.add_option("--model", model_names,
+                   "Name of the model to execute, repeat to run several "
+                   "models concurrently")
         ->required();
 
-    app.add_option("--input", inputs, "Input data files");
+    auto input = app.add_option("--input", inputs, "Input data files");
 
     app.add_option("--golden", goldens, "Golden (reference) files");
 
+    auto manifest =
+        app.add_option("--manifest", dataset.manifest,
+                       "CSV file of input and golden files, one sample per "
+                       "line")
+            ->check(CLI::ExistingFile)
+            ->excludes(input);
+
+    app.add_option("--input-dir", dataset.input_dir,
+                   "Directory with one sub-directory of input and golden "
+                   "files per sample")
+        ->check(CLI::ExistingDirectory)
+        ->excludes(input)
+        ->excludes(manifest);
+
     app.add_option("--iteration", iteration,
                    "Number of iterations to run the model")
         ->check(CLI::NonNegativeNumber);
@@ -364,6 +1990,57 @@ void parse_arguments(int argc, char **argv, std::string &model_name,
 
     app.add_flag("--force", force, "Run the model without input data");
 
+    app.add_option("--warmup", benchmark.warmup,
+                   "Number of untimed iterations before measuring")
+        ->check(CLI::NonNegativeNumber);
+
+    app.add_option("--duration-sec", benchmark.duration_sec,
+                   "Run the model for a fixed time instead of --iteration")
+        ->check(CLI::NonNegativeNumber);
+
+    app.add_option("--histogram", benchmark.histogram_bins,
+                   "Number of bins of the printed latency histogram")
+        ->check(CLI::NonNegativeNumber);
+
+    app.add_option("--report", benchmark.report_format,
+                   "Write a benchmark report in the given format")
+        ->check(CLI::IsMember({"json", "csv"}));
+
+    app.add_option("--report-path", benchmark.report_path,
+                   "Path of the benchmark report file");
+
+    app.add_flag("--async", benchmark.async_mode,
+                 "Pipeline executions with EnnExecuteModelAsync/Wait");
+
+    app.add_option("--inflight", benchmark.inflight,
+                   "Number of sessions kept in flight in --async mode")
+        ->check(CLI::Range(1, 16));
+
+    app.add_flag("--sweep-preferences", benchmark.sweep_preferences,
+                 "Measure every perf mode and core affinity, then write the "
+                 "fastest to --preferences-path");
+
+    app.add_option("--affinity-masks", benchmark.affinity_masks,
+                   "NPU core affinity masks tried by --sweep-preferences")
+        ->capture_default_str();
+
+    app.add_option("--preferences-path", benchmark.preferences_path,
+                   "Preferences file written by --sweep-preferences")
+        ->capture_default_str();
+
+    auto profile =
+        app.add_flag("--profile-lifecycle", benchmark.profile_lifecycle,
+                     "Time every step from EnnInitialize to EnnDeinitialize");
+
+    app.add_option("--compare-open", benchmark.compare_open,
+                   "Open the model this many times from file and from memory "
+                   "in --profile-lifecycle mode")
+        ->check(CLI::NonNegativeNumber)
+        ->needs(profile);
+
+    app.add_flag("--quiet", benchmark.quiet,
+                 "Do not print the execution time of each iteration");
+
     try {
         app.parse(argc, argv);
     } catch (const CLI::ParseError &e) {
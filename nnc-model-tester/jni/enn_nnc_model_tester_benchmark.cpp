@@ -0,0 +1,214 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Microbenchmarks of the kernels enn_nnc_model_tester runs on every output
+// and input file. Data is generated from a fixed seed, so that runs of the
+// same build on the same machine can be compared.
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "include/CLI11.hpp"
+#include "include/enn_nnc_model_tester.h"
+
+typedef struct _Kernel {
+    std::string name;
+    size_t bytes;  // bytes read by one call
+    std::function<void()> run;
+} Kernel;
+
+// Keeps the compiler from dropping calls whose result is unused
+volatile double g_sink;
+
+std::vector<uint8_t> random_bytes(const size_t size, const uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::vector<uint8_t> bytes(size);
+
+    for (auto &byte : bytes) byte = static_cast<uint8_t>(generator());
+
+    return bytes;
+}
+
+std::vector<float> random_floats(const size_t count, const uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> distribution(0.0F, 1.0F);
+    std::vector<float> values(count);
+
+    for (auto &value : values) value = distribution(generator);
+
+    return values;
+}
+
+// Finite half values with a random sign, exponent and mantissa
+std::vector<uint16_t> random_halves(const size_t count, const uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::vector<uint16_t> values(count);
+
+    for (auto &value : values) {
+        const uint32_t bits = generator();
+        value = static_cast<uint16_t>((bits & 0x83FF) |
+                                      ((8 + (bits >> 16) % 16) << 10));
+    }
+
+    return values;
+}
+
+// Output data close to the golden data, so both branches of the threshold
+// test are taken
+template <typename T>
+std::vector<T> perturb(const std::vector<T> &golden, const uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::vector<T> output(golden);
+
+    for (auto &value : output) {
+        if (generator() % 4 == 0) value = static_cast<T>(value + 1);
+    }
+
+    return output;
+}
+
+std::vector<float> perturb(const std::vector<float> &golden,
+                           const uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> distribution(0.0F, 1e-3F);
+    std::vector<float> output(golden);
+
+    for (auto &value : output) value += distribution(generator);
+
+    return output;
+}
+
+template <typename T>
+Kernel compare_kernel(const std::string &type_name, const uint32_t type,
+                      const std::vector<T> &golden,
+                      const std::vector<T> &output) {
+    const size_t size = golden.size() * sizeof(T);
+    const T *control = golden.data();
+    const T *test = output.data();
+
+    return {"compare_buffer/" + type_name, 2 * size, [=]() {
+                g_sink = compare_buffer(type, control, test, size, 1e-3F).snr;
+            }};
+}
+
+std::vector<int64_t> measure(const Kernel &kernel, const int warmup,
+                             const int repeat) {
+    std::vector<int64_t> durations;
+
+    for (int idx = 0; idx < warmup; idx++) kernel.run();
+
+    for (int idx = 0; idx < repeat; idx++) {
+        auto start = std::chrono::steady_clock::now();
+        kernel.run();
+        auto end = std::chrono::steady_clock::now();
+        durations.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count());
+    }
+
+    return durations;
+}
+
+int main(int argc, char *argv[]) {
+    size_t elements = size_t(1) << 20;
+    int warmup = 5;
+    int repeat = 50;
+    std::string filter;
+    std::string work_dir = ".";
+
+    CLI::App app("ENN SDK NNC Model Tester Kernel Benchmark");
+
+    app.add_option("--elements", elements,
+                   "Number of elements of every benchmarked buffer")
+        ->capture_default_str()
+        ->check(CLI::PositiveNumber);
+    app.add_option("--warmup", warmup,
+                   "Number of untimed calls before measuring")
+        ->capture_default_str()
+        ->check(CLI::NonNegativeNumber);
+    app.add_option("--repeat", repeat, "Number of measured calls")
+        ->capture_default_str()
+        ->check(CLI::PositiveNumber);
+    app.add_option("--filter", filter,
+                   "Only run the kernels whose name contains this text");
+    app.add_option("--work-dir", work_dir,
+                   "Directory of the temporary file read by copy_file_to_mem")
+        ->capture_default_str()
+        ->check(CLI::ExistingDirectory);
+
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError &e) {
+        return app.exit(e);
+    }
+
+    const auto float_golden = random_floats(elements, 1);
+    const auto float_output = perturb(float_golden, 2);
+    const auto half_golden = random_halves(elements, 3);
+    const auto half_output = perturb(half_golden, 4);
+    const auto uint8_golden = random_bytes(elements, 5);
+    const auto uint8_output = perturb(uint8_golden, 6);
+    const std::vector<int8_t> int8_golden(uint8_golden.begin(),
+                                          uint8_golden.end());
+    const auto int8_output = perturb(int8_golden, 7);
+
+    // The file stays in the page cache, so only the map and copy are timed
+    const std::string file_name =
+        work_dir + "/enn_benchmark_" + std::to_string(getpid()) + ".bin";
+    const auto file_data = random_bytes(elements * sizeof(float), 8);
+    std::vector<char> file_dst(file_data.size());
+
+    if (copy_mem_to_file(reinterpret_cast<const char *>(file_data.data()),
+                         file_name.c_str(), file_data.size())) {
+        return FAILURE;
+    }
+
+    std::vector<Kernel> kernels = {
+        compare_kernel("FLOAT32", BufferType_FLOAT32, float_golden,
+                       float_output),
+        compare_kernel("FLOAT16", BufferType_FLOAT16, half_golden,
+                       half_output),
+        compare_kernel("UINT8", BufferType_UINT8, uint8_golden, uint8_output),
+        compare_kernel("INT8", BufferType_INT8, int8_golden, int8_output),
+        {"copy_file_to_mem", file_data.size(),
+         [&]() {
+             g_sink = copy_file_to_mem(file_name.c_str(), file_dst.data(),
+                                       file_dst.size());
+         }},
+    };
+
+    std::cout << "Kernel Benchmark (" << elements << " elements, " << repeat
+              << " repeats, microseconds):" << std::endl;
+    std::cout << std::setfill(' ') << std::left << std::setw(26) << "Kernel"
+              << std::setw(10) << "p50" << std::setw(10) << "min"
+              << std::setw(10) << "avg" << std::setw(10) << "stddev"
+              << "GB/s(p50)" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (const auto &kernel : kernels) {
+        if (kernel.name.find(filter) == std::string::npos) continue;
+
+        const LatencyStats stats =
+            compute_latency_stats(measure(kernel, warmup, repeat));
+
+        std::cout << std::setw(26) << kernel.name << std::setw(10)
+                  << stats.p50 / 1e3 << std::setw(10) << stats.min / 1e3
+                  << std::setw(10) << stats.mean / 1e3 << std::setw(10)
+                  << stats.stddev / 1e3 << std::setprecision(2)
+                  << kernel.bytes / static_cast<double>(stats.p50)
+                  << std::setprecision(1) << std::endl;
+    }
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6) << std::right;
+
+    remove(file_name.c_str());
+
+    return SUCCESS;
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Checks compare_buffer() on float buffers against a plain double precision
+// loop. On arm64 the blocks of 4 elements take the NEON path and the rest the
+// scalar tail, so the lengths cover empty buffers, tails and several blocks.
+// Mismatches and the max abs error must match exactly, the sums only up to
+// their order of accumulation.
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "include/enn_nnc_model_tester.h"
+
+int g_failures = 0;
+
+void expect(const bool condition, const char *name, const size_t count,
+            const char *statistic, const double value, const double expected) {
+    if (condition) return;
+
+    fprintf(stderr, "%s, %zu elements: %s is %.17g, expected %.17g\n", name,
+            count, statistic, value, expected);
+    g_failures++;
+}
+
+bool same_value(const double value, const double expected) {
+    return value == expected || (std::isnan(value) && std::isnan(expected));
+}
+
+bool close_value(const double value, const double expected) {
+    return same_value(value, expected) ||
+           std::abs(value - expected) <= 1e-12 * std::abs(expected);
+}
+
+// compare_outputs() as one double precision pass without vectorization
+CompareStats reference_compare(const std::vector<float> &control,
+                               const std::vector<float> &test,
+                               const double threshold) {
+    CompareStats stats = {control.size(), 0, 0, 0, 0, 0};
+    double signal = 0, noise = 0, dot = 0, output = 0;
+
+    for (size_t idx = 0; idx < control.size(); idx++) {
+        const double golden = control[idx];
+        const double value = test[idx];
+        const double abs_error = std::abs(value - golden);
+
+        if (!(abs_error <= threshold)) stats.mismatches++;
+        if (abs_error > stats.max_abs_error || std::isnan(abs_error)) {
+            stats.max_abs_error = abs_error;
+        }
+
+        signal += golden * golden;
+        noise += abs_error * abs_error;
+        dot += value * golden;
+        output += value * value;
+    }
+
+    stats.rmse = control.empty() ? 0 : std::sqrt(noise / control.size());
+    stats.snr = noise == 0 ? INFINITY : 10 * log10(signal / noise);
+    if (signal == 0 || output == 0) {
+        stats.cosine = signal == output ? 1 : 0;
+    } else {
+        stats.cosine = dot / std::sqrt(signal * output);
+    }
+
+    return stats;
+}
+
+void check_compare(const char *name, const std::vector<float> &control,
+                   const std::vector<float> &test, const float threshold) {
+    const size_t count = control.size();
+    const CompareStats stats =
+        compare_buffer(BufferType_FLOAT32, control.data(), test.data(),
+                       count * sizeof(float), threshold);
+    const CompareStats expected = reference_compare(control, test, threshold);
+
+    expect(stats.count == expected.count, name, count, "count",
+           static_cast<double>(stats.count),
+           static_cast<double>(expected.count));
+    expect(stats.mismatches == expected.mismatches, name, count, "mismatches",
+           static_cast<double>(stats.mismatches),
+           static_cast<double>(expected.mismatches));
+    expect(same_value(stats.max_abs_error, expected.max_abs_error), name,
+           count, "max abs error", stats.max_abs_error,
+           expected.max_abs_error);
+    expect(close_value(stats.rmse, expected.rmse), name, count, "rmse",
+           stats.rmse, expected.rmse);
+    expect(close_value(stats.snr, expected.snr), name, count, "snr",
+           stats.snr, expected.snr);
+    expect(close_value(stats.cosine, expected.cosine), name, count, "cosine",
+           stats.cosine, expected.cosine);
+}
+
+// Golden data, and output close to it, so both branches of the threshold
+// test are taken
+void make_buffers(const size_t count, const uint32_t seed,
+                  std::vector<float> &control, std::vector<float> &test) {
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> value(0.0F, 1.0F);
+    std::normal_distribution<float> error(0.0F, 1e-3F);
+
+    control.resize(count);
+    test.resize(count);
+    for (size_t idx = 0; idx < count; idx++) {
+        control[idx] = value(generator);
+        test[idx] = control[idx] + error(generator);
+    }
+}
+
+int main() {
+    const size_t lengths[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 1023, 4096};
+    std::vector<float> control, test;
+
+    for (const size_t count : lengths) {
+        make_buffers(count, static_cast<uint32_t>(count) + 1, control, test);
+        check_compare("random", control, test, 1e-3F);
+        check_compare("identical", control, control, 0);
+    }
+
+    // Errors that float subtraction rounds: 1 - (-1e-8) is 1 in float, which
+    // is not above a threshold of 1, and 1 - 1e-8 is reported as exactly 1
+    for (const size_t count : lengths) {
+        control.assign(count, -1e-8F);
+        test.assign(count, 1.0F);
+        check_compare("rounded mismatch", control, test, 1.0F);
+
+        control.assign(count, 1e-8F);
+        check_compare("rounded error", control, test, 1.0F);
+    }
+
+    // Values near the float range, whose squares only fit in double
+    for (const size_t count : lengths) {
+        control.assign(count, 3e38F);
+        test.assign(count, -3e38F);
+        check_compare("large", control, test, 0);
+    }
+
+    // NaN and infinite outputs count as mismatches and propagate to the max
+    // error, in the NEON blocks and in the tail
+    for (const size_t count : {size_t(4), size_t(5), size_t(9)}) {
+        for (size_t position = 0; position < count; position++) {
+            make_buffers(count, 7, control, test);
+            test[position] = std::numeric_limits<float>::quiet_NaN();
+            check_compare("nan", control, test, 1e-3F);
+
+            make_buffers(count, 7, control, test);
+            test[position] = std::numeric_limits<float>::infinity();
+            check_compare("infinity", control, test, 1e-3F);
+        }
+    }
+
+    if (g_failures) {
+        printf("enn_nnc_model_tester_test: %d checks failed\n", g_failures);
+        return 1;
+    }
+
+    printf("enn_nnc_model_tester_test: passed\n");
+    return 0;
+}
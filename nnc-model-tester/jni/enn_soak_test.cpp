@@ -0,0 +1,204 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Feeds camera-sized frames through the ENN calls of the sample apps' runtime
+// (enn-runtime/enn_runtime.cc) for a long session and checks that the
+// resident set size stays flat, so that a per-frame leak shows up as growth.
+// Built against the simulated ENN runtime.
+//
+// - ring: frames are written into the input of sessions 1..2 and executed
+//   asynchronously, the oldest one collected once both are in flight, like
+//   ennRingExecuteAsync and ennRingWait.
+// - buffer sets: buffer sets are allocated, executed and released, like a
+//   camera session opening and closing the model executor.
+//
+//   enn_soak_test [--frames N]
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "include/enn_api-public_ndk_v1.hpp"
+
+namespace {
+
+// 224x224 RGB input and 1000 class scores, executed without compute or
+// latency so that the API paths dominate
+const char MODEL[] =
+    "input input_0 1 224 224 3 UINT8\n"
+    "output output_0 1 1 1 1000 FLOAT32\n"
+    "latency_us 0\n"
+    "compute off\n";
+
+constexpr int kRingDepth = 2;
+
+// Growth allowed after the warmup, for allocator caches and thread stacks
+// being reused at different addresses
+constexpr long kRssSlackKb = 1024;
+
+int g_failures = 0;
+
+long rss_kb() {
+    long pages = 0, resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (statm) {
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        fclose(statm);
+    }
+
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void expect(const bool condition, const char *what) {
+    if (condition) return;
+
+    fprintf(stderr, "%s\n", what);
+    g_failures++;
+}
+
+// Runs frames iterations of step and checks the RSS after the first tenth
+// against the RSS at the end
+template <typename Step>
+void soak(const char *name, const int frames, Step step) {
+    const int warmup = frames / 10;
+    long warm_rss = 0;
+
+    for (int frame = 0; frame < frames; frame++) {
+        if (frame == warmup) warm_rss = rss_kb();
+        if (!step(frame)) {
+            fprintf(stderr, "%s: frame %d failed\n", name, frame);
+            g_failures++;
+            return;
+        }
+    }
+
+    const long end_rss = rss_kb();
+    printf("%-12s %8d frames  RSS %ld kB after warmup, %ld kB at end\n", name,
+           frames, warm_rss, end_rss);
+    if (end_rss - warm_rss > kRssSlackKb) {
+        fprintf(stderr, "%s: RSS grew by %ld kB\n", name, end_rss - warm_rss);
+        g_failures++;
+    }
+}
+
+EnnBufferPtr *allocate(const EnnModelId model_id, const int session_id,
+                       NumberOfBuffersInfo &info) {
+    EnnBufferPtr *buffers = nullptr;
+
+    if (enn::api::EnnAllocateAllBuffers(model_id, &buffers, &info,
+                                        session_id)) {
+        return nullptr;
+    }
+
+    return buffers;
+}
+
+void release(EnnBufferPtr *buffers, const NumberOfBuffersInfo &info) {
+    enn::api::EnnReleaseBuffers(buffers, info.n_in_buf + info.n_out_buf);
+}
+
+void soak_ring(const EnnModelId model_id, const int frames,
+               const std::vector<uint8_t> &frame_data) {
+    EnnBufferPtr *sessions[kRingDepth];
+    NumberOfBuffersInfo info;
+
+    for (int slot = 0; slot < kRingDepth; slot++) {
+        sessions[slot] = allocate(model_id, slot + 1, info);
+        if (!sessions[slot]) {
+            expect(false, "ring: EnnAllocateAllBuffers failed");
+            for (int allocated = 0; allocated < slot; allocated++) {
+                release(sessions[allocated], info);
+            }
+            return;
+        }
+    }
+
+    int in_flight = 0;
+
+    soak("ring", frames, [&](const int frame) {
+        const int slot = frame % kRingDepth;
+        EnnBufferPtr input = sessions[slot][0];
+
+        memcpy(input->va, frame_data.data(),
+               std::min<size_t>(input->size, frame_data.size()));
+        if (enn::api::EnnExecuteModelAsync(model_id, slot + 1)) return false;
+        in_flight++;
+
+        // Once every session is in flight, the oldest one is collected
+        if (in_flight == kRingDepth) {
+            const int oldest = (slot + 1) % kRingDepth;
+            if (enn::api::EnnExecuteModelWait(model_id, oldest + 1)) {
+                return false;
+            }
+            in_flight--;
+        }
+        return true;
+    });
+
+    for (int slot = 0; slot < kRingDepth && in_flight > 0; slot++) {
+        if (!enn::api::EnnExecuteModelWait(model_id, slot + 1)) in_flight--;
+    }
+    for (auto buffers : sessions) release(buffers, info);
+}
+
+void soak_buffer_sets(const EnnModelId model_id, const int frames,
+                      const std::vector<uint8_t> &frame_data) {
+    soak("buffer sets", frames, [&](const int) {
+        NumberOfBuffersInfo info;
+        EnnBufferPtr *buffers = allocate(model_id, 0, info);
+        if (!buffers) return false;
+
+        memcpy(buffers[0]->va, frame_data.data(),
+               std::min<size_t>(buffers[0]->size, frame_data.size()));
+        const bool executed = !enn::api::EnnExecuteModel(model_id);
+        release(buffers, info);
+
+        return executed;
+    });
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    int frames = 100000;
+
+    for (int idx = 1; idx < argc; idx++) {
+        if (!strcmp(argv[idx], "--frames") && idx + 1 < argc) {
+            frames = std::max(10, atoi(argv[++idx]));
+        } else {
+            fprintf(stderr, "Usage: %s [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    EnnModelId model_id;
+    if (enn::api::EnnInitialize() ||
+        enn::api::EnnOpenModelFromMemory(MODEL, sizeof(MODEL) - 1,
+                                         &model_id)) {
+        fprintf(stderr, "Opening the simulated model failed\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> frame_data(224 * 224 * 3);
+    for (size_t idx = 0; idx < frame_data.size(); idx++) {
+        frame_data[idx] = static_cast<uint8_t>(idx * 31);
+    }
+
+    soak_ring(model_id, frames, frame_data);
+    soak_buffer_sets(model_id, frames, frame_data);
+
+    enn::api::EnnCloseModel(model_id);
+    enn::api::EnnDeinitialize();
+
+    if (g_failures) {
+        printf("enn_soak_test: %d checks failed\n", g_failures);
+        return 1;
+    }
+
+    printf("enn_soak_test: passed\n");
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <string>
+#include <vector>
 
 #include "include/enn_api-public_ndk_v1.hpp"
 
@@ -29,6 +30,89 @@ typedef enum _BufferType {
     BufferType_MAX = BufferType_UINT32
 } BufferType;
 
+typedef struct _BenchmarkOptions {
+    int warmup = 0;               // untimed iterations before measuring
+    double duration_sec = 0;      // if > 0, run for this long instead
+    int histogram_bins = 0;       // 0 disables the printed histogram
+    std::string report_format;    // "json", "csv" or empty for no report
+    std::string report_path;      // defaults to benchmark_report.<format>
+    bool quiet = false;           // suppress per-iteration output
+    bool async_mode = false;      // use EnnExecuteModelAsync/Wait
+    int inflight = 2;             // sessions kept in flight in async mode
+    bool sweep_preferences = false;  // try every perf mode and affinity
+    std::vector<uint32_t> affinity_masks = {0x1, 0x2, 0x3};  // NPU cores
+    std::string preferences_path = "enn_preferences.cfg";  // best result
+    bool profile_lifecycle = false;  // time every step from init to deinit
+    int compare_open = 0;  // repeated opens from file and from memory
+} BenchmarkOptions;
+
+typedef struct _DatasetOptions {
+    std::string manifest;   // CSV file, one sample per line
+    std::string input_dir;  // directory with one sub-directory per sample
+} DatasetOptions;
+
+typedef struct _DatasetSample {
+    std::string name;
+    std::vector<std::string> inputs;
+    std::vector<std::string> goldens;  // empty if the sample is not checked
+} DatasetSample;
+
+typedef struct _LatencyStats {
+    size_t count;
+    double mean;
+    double stddev;
+    int64_t min;
+    int64_t max;
+    int64_t p50;
+    int64_t p90;
+    int64_t p99;
+    double throughput;  // inferences per second of wall time
+} LatencyStats;
+
+// Preferences the sample apps' ennInitialize() reads from a preferences file
+typedef struct _EnnPreferences {
+    uint32_t perf_mode;
+    uint32_t core_affinity;
+    uint32_t preset_id;
+    uint32_t perf_config_id;
+    uint32_t priority;
+} EnnPreferences;
+
+typedef struct _PreferenceResult {
+    EnnPreferences preferences;
+    bool supported;  // false if the framework rejected the preference
+    LatencyStats stats;
+} PreferenceResult;
+
+typedef struct _CompareStats {
+    size_t count;          // number of compared elements
+    size_t mismatches;     // elements differing by more than the threshold
+    double snr;            // golden power over error power, in dB
+    double max_abs_error;
+    double rmse;
+    double cosine;         // cosine similarity of output and golden data
+} CompareStats;
+
+typedef struct _MappedFile {
+    const char* data;  // read-only mapping, null for an empty file
+    size_t size;
+} MappedFile;
+
+// Raw IEEE 754 half precision value of a FLOAT16 buffer
+typedef struct _Half {
+    uint16_t bits;
+} Half;
+
+typedef struct _ConcurrentModel {
+    std::string name;
+    EnnModelId model_id;
+    EnnBufferPtr* buffer_set;
+    NumberOfBuffersInfo buffer_info;
+    std::vector<int64_t> solo;        // executed alone, in microseconds
+    std::vector<int64_t> concurrent;  // executed next to the other models
+    int64_t solo_wall_time = 0;
+} ConcurrentModel;
+
 const std::string ERROR_COLOR = "\033[1;31m";
 const std::string SUCCESS_COLOR = "\033[1;32m";
 const std::string RESET_COLOR = "\033[0m";
@@ -43,50 +127,365 @@ const std::string RESET_COLOR = "\033[0m";
  * @param threshold Tolerance value for comparing model outputs with golden
  * references.
  * @param iteration Number of execution repetitions.
+ * @param benchmark Warmup, duration and report settings of the measurement.
+ * @param dataset If a manifest or input directory is set, runs every sample
+ * of the dataset once instead of the benchmark.
  * @return 0 for success, non-zero for failure.
  */
 int execute_model(const std::string model_name,
                   const std::vector<std::string>& inputs,
                   const std::vector<std::string>& goldens,
                   const bool force_mode, const float threshold,
-                  const int iteration);
+                  const int iteration, const BenchmarkOptions& benchmark,
+                  const DatasetOptions& dataset);
 
 /**
- * @brief Compares two data arrays and calculates the number of differences
- * based on a threshold.
+ * @brief Runs several models at once, each from its own thread, and compares
+ * their latency with solo runs of the same models.
  *
- * @tparam T Type of the data.
- * @param data1 Pointer to the first data array.
- * @param data2 Pointer to the second data array.
- * @param size Size of the data arrays.
- * @param threshold Threshold value beyond which differences are counted.
- * @return Returns the number of elements in the arrays that differ by more than
- * the threshold.
+ * The models run with their buffers as allocated, like --force mode.
+ *
+ * @param model_names Models to open.
+ * @param iteration Number of executions of each model, unless a duration is
+ * set.
+ * @param benchmark Warmup and duration settings.
+ * @return 0 for success, non-zero for failure.
  */
-template <typename T>
-int compare_data(T* data1, T* data2, int size, T threshold = 0);
+int execute_concurrent(const std::vector<std::string>& model_names,
+                       const int iteration, const BenchmarkOptions& benchmark);
+
+/**
+ * @brief Measures each model alone, then all models at once from one thread
+ * per model, and prints the latency and throughput of both runs.
+ *
+ * @param models Opened models with allocated buffers.
+ * @param iteration Number of executions of each model, unless a duration is
+ * set.
+ * @param benchmark Warmup and duration settings.
+ * @return 0 on success, 1 on error.
+ */
+int run_concurrent_benchmark(std::vector<ConcurrentModel>& models,
+                             const int iteration,
+                             const BenchmarkOptions& benchmark);
+
+/**
+ * @brief Measures the model under every combination of performance mode and
+ * NPU core affinity, prints them ranked by average latency and writes the
+ * best one to a preferences file.
+ *
+ * The file holds one key=value pair per line and is read by the sample apps'
+ * ennInitialize().
+ *
+ * Each combination is set before the model is opened, as in the sample apps,
+ * and the model is closed again after it is measured. The preferences from
+ * before the sweep are restored at the end; the file records them along with
+ * the fastest perf mode and core affinity.
+ *
+ * @param model_name Path of the model, opened once per combination.
+ * @param inputs Input files, unless force_mode is set.
+ * @param force_mode Execute without loading the inputs.
+ * @param iteration Number of executions per combination, unless a duration
+ * is set.
+ * @param benchmark Warmup, duration, affinity masks and file path settings.
+ * @return 0 on success, 1 on error.
+ */
+int run_preference_sweep(const std::string& model_name,
+                         const std::vector<std::string>& inputs,
+                         const bool force_mode, const int iteration,
+                         const BenchmarkOptions& benchmark);
+
+/**
+ * @brief Reads the current ENN preferences.
+ *
+ * @param preferences Filled with the preferences.
+ * @return 0 on success, 1 on error.
+ */
+int get_preferences(EnnPreferences& preferences);
+
+/**
+ * @brief Sets all ENN preferences, as ennInitialize() does from a file.
+ *
+ * @param preferences Preferences to set.
+ * @return 0 on success, 1 on error.
+ */
+int set_preferences(const EnnPreferences& preferences);
+
+/**
+ * @brief Writes the preferences of a sweep result to a file.
+ *
+ * @param path Path of the preferences file.
+ * @param model_name Name of the measured model.
+ * @param best Preferences to write.
+ * @return 0 on success, 1 on error.
+ */
+int write_preferences(const std::string& path, const std::string& model_name,
+                      const PreferenceResult& best);
 
 /**
- * @brief Calculates the Signal-to-Noise Ratio (SNR) between control and test
- * data arrays.
+ * @brief Times every step of the model lifecycle, from EnnInitialize() to
+ * EnnDeinitialize(), and prints the breakdown.
  *
- * @tparam T Type of the data.
- * @param control_data Pointer to the control data array.
- * @param test_data Pointer to the test data array.
- * @param size Size of the data arrays.
- * @return Returns the calculated SNR value.
+ * The first inference is reported apart from the steady-state ones. If
+ * compare_open is set, the model is also opened that many times with
+ * EnnOpenModel() and with EnnOpenModelFromMemory() on a mapped copy of the
+ * file before the framework is deinitialized.
+ *
+ * @param model_name Identifier of the NNC model.
+ * @param inputs Paths to input files.
+ * @param force_mode If true, runs the model without input data.
+ * @param iteration Number of steady-state executions, unless a duration is
+ * set.
+ * @param benchmark Duration, verbosity and open comparison settings.
+ * @return 0 for success, non-zero for failure.
+ */
+int profile_lifecycle(const std::string model_name,
+                      const std::vector<std::string>& inputs,
+                      const bool force_mode, const int iteration,
+                      const BenchmarkOptions& benchmark);
+
+/**
+ * @brief Opens and closes a model repeatedly, alternating between
+ * EnnOpenModel() on its path and EnnOpenModelFromMemory() on a mapping of
+ * the file, and prints the open latency of both.
+ *
+ * @param model_name Path of the NNC model.
+ * @param repeats Number of opens with each function.
+ * @return 0 on success, 1 on error.
+ */
+int compare_open_latency(const std::string& model_name, const int repeats);
+
+/**
+ * @brief Releases the buffers of session 0, closes the model and
+ * deinitializes the framework.
+ *
+ * @param model_id Model's unique identifier.
+ * @param buffer_set Buffer set of session 0.
+ * @param buffer_info Number of buffers in the set.
+ * @return 0 on success, 1 on error.
+ */
+int release_model(const EnnModelId model_id, EnnBufferPtr* buffer_set,
+                  const NumberOfBuffersInfo buffer_info);
+
+/**
+ * @brief Reads the samples of a manifest file.
+ *
+ * Each line holds the comma separated input files of one sample, optionally
+ * followed by its golden files. Empty lines and lines starting with '#' are
+ * skipped, and relative paths are resolved against the manifest's directory.
+ *
+ * @param manifest Path of the manifest file.
+ * @param buffer_info Number of input and output layers of the model.
+ * @param samples [OUT] Samples in file order.
+ * @return 0 on success, 1 on error.
+ */
+int load_manifest(const std::string& manifest,
+                  const NumberOfBuffersInfo buffer_info,
+                  std::vector<DatasetSample>& samples);
+
+/**
+ * @brief Lists the samples of an input directory.
+ *
+ * Every sub-directory is a sample holding input0.bin, input1.bin, ... and,
+ * if the sample is checked, golden0.bin, golden1.bin, ...
+ *
+ * @param input_dir Path of the dataset directory.
+ * @param buffer_info Number of input and output layers of the model.
+ * @param samples [OUT] Samples sorted by directory name.
+ * @return 0 on success, 1 on error.
+ */
+int scan_input_dir(const std::string& input_dir,
+                   const NumberOfBuffersInfo buffer_info,
+                   std::vector<DatasetSample>& samples);
+
+/**
+ * @brief Runs every sample of a dataset once through the same buffers.
+ *
+ * The files of the next sample are mapped and faulted in on a background
+ * thread while the current sample executes. Each sample's outputs are
+ * compared with its goldens, and the match rate, SNR and latency over the
+ * whole dataset are printed at the end.
+ *
+ * @param model_id Model's unique identifier.
+ * @param buffer_set Buffer set of session 0.
+ * @param buffer_info Number of buffers in the set.
+ * @param samples Samples to execute.
+ * @param threshold Threshold for matching data.
+ * @param benchmark Verbosity and histogram settings.
+ * @return 0 on success, 1 if the model failed to execute. Samples whose
+ * files cannot be loaded are skipped.
+ */
+int run_dataset_sweep(const EnnModelId model_id, EnnBufferPtr* buffer_set,
+                      const NumberOfBuffersInfo buffer_info,
+                      const std::vector<DatasetSample>& samples,
+                      const float threshold,
+                      const BenchmarkOptions& benchmark);
+
+/**
+ * @brief Executes the model back to back with the blocking API and records
+ * the execution time of each run.
+ *
+ * @param model_id Model's unique identifier.
+ * @param iteration Number of executions, unless a duration is set.
+ * @param benchmark Duration and verbosity settings.
+ * @param durations [OUT] Execution times in microseconds.
+ * @return 0 on success, 1 on error.
+ */
+int run_sync_loop(const EnnModelId model_id, const int iteration,
+                  const BenchmarkOptions& benchmark,
+                  std::vector<int64_t>& durations);
+
+/**
+ * @brief Keeps several sessions in flight with EnnExecuteModelAsync() and
+ * records the submit-to-completion latency of each request.
+ *
+ * Each session must already have its buffers allocated and committed under
+ * its own session ID (0 to n_sessions - 1).
+ *
+ * @param model_id Model's unique identifier.
+ * @param n_sessions Number of sessions kept in flight.
+ * @param iteration Number of executions, unless a duration is set.
+ * @param benchmark Duration and verbosity settings.
+ * @param durations [OUT] Latencies in microseconds, in completion order.
+ * @return 0 on success, 1 on error.
+ */
+int run_async_pipeline(const EnnModelId model_id, const int n_sessions,
+                       const int iteration, const BenchmarkOptions& benchmark,
+                       std::vector<int64_t>& durations);
+
+/**
+ * @brief Releases the buffer sets of several sessions.
+ *
+ * @param sessions Buffer sets from EnnAllocateAllBuffers().
+ * @param buffer_info Number of buffers in each set.
+ */
+void release_sessions(const std::vector<EnnBufferPtr*>& sessions,
+                      const NumberOfBuffersInfo buffer_info);
+
+/**
+ * @brief Computes summary statistics of measured execution times.
+ *
+ * Percentiles use the nearest-rank method over the sorted samples.
+ *
+ * @param durations Execution times in microseconds.
+ * @return Returns the mean, standard deviation, extremes and percentiles.
+ */
+LatencyStats compute_latency_stats(const std::vector<int64_t>& durations);
+
+/**
+ * @brief Prints latency statistics to stdout.
+ *
+ * @param stats Statistics from compute_latency_stats().
+ */
+void print_latency_stats(const LatencyStats& stats);
+
+/**
+ * @brief Counts execution times into equal-width bins between min and max.
+ *
+ * @param durations Execution times in microseconds.
+ * @param stats Statistics of the same samples.
+ * @param bins Number of bins.
+ * @return Returns the number of samples in each bin.
+ */
+std::vector<int> build_latency_histogram(const std::vector<int64_t>& durations,
+                                         const LatencyStats& stats,
+                                         const int bins);
+
+/**
+ * @brief Prints a latency histogram as text bars to stdout.
+ *
+ * @param durations Execution times in microseconds.
+ * @param stats Statistics of the same samples.
+ * @param bins Number of bins.
+ */
+void print_latency_histogram(const std::vector<int64_t>& durations,
+                             const LatencyStats& stats, const int bins);
+
+/**
+ * @brief Escapes a string for use inside a JSON string literal.
+ *
+ * Quotes, backslashes and control characters are escaped, so that model paths
+ * of any content produce a valid report.
+ *
+ * @param value String to escape.
+ * @return Escaped string, without the surrounding quotes.
+ */
+std::string escape_json_string(const std::string& value);
+
+/**
+ * @brief Quotes a CSV field if it contains a separator, quote or line break.
+ *
+ * @param value Field to quote.
+ * @return The field as it is written to the CSV report.
+ */
+std::string quote_csv_field(const std::string& value);
+
+/**
+ * @brief Writes the benchmark result to a JSON or CSV file.
+ *
+ * The JSON report contains the summary, the histogram and every sample. The
+ * CSV report contains a single summary row so that runs can be concatenated.
+ *
+ * @param model_name Name of the executed model.
+ * @param benchmark Benchmark settings, including report format and path.
+ * @param durations Execution times in microseconds.
+ * @param stats Statistics of the same samples.
+ * @return 0 on success, 1 on error.
+ */
+int write_benchmark_report(const std::string& model_name,
+                           const BenchmarkOptions& benchmark,
+                           const std::vector<int64_t>& durations,
+                           const LatencyStats& stats);
+
+/**
+ * @brief Compares output data with golden data in a single pass.
+ *
+ * Every statistic is accumulated in double precision, so the result does not
+ * drift on large tensors. Float data takes a NEON path on arm64 targets.
+ *
+ * @tparam T Element type (e.g., float, uint8_t, Half).
+ * @param control Pointer to the golden data.
+ * @param test Pointer to the output data.
+ * @param count Number of elements in both arrays.
+ * @param threshold Absolute difference beyond which an element mismatches.
+ * @return Returns the mismatch count, SNR, max abs error, RMSE and cosine
+ * similarity of the output against the golden data.
  */
 template <typename T>
-float calculate_snr(T* control_data, T* test_data, int size);
+CompareStats compare_outputs(const T* control, const T* test,
+                             const size_t count, const double threshold = 0);
+
+/**
+ * @brief Maps a file read-only into memory.
+ *
+ * The mapping is advised for sequential access. An empty file succeeds with
+ * a null pointer and a size of 0.
+ *
+ * @param filename Name/path of the file to map.
+ * @param file [OUT] Address and size of the mapping.
+ * @return 0 on success, 1 on error.
+ */
+int map_file(const char* filename, MappedFile& file);
+
+/**
+ * @brief Releases a mapping created by map_file().
+ *
+ * @param file Mapping to release, reset to an empty mapping.
+ */
+void unmap_file(MappedFile& file);
 
 /**
  * @brief Copies the content of a file into memory.
  *
+ * The file is mapped rather than read through stdio, and it is only copied
+ * when its size equals the size of the destination buffer.
+ *
  * @param filename Name/path of the file to read from.
  * @param dst Pointer to the destination memory buffer.
- * @return Returns the size of the read data in bytes or -1 in case of an error.
+ * @param dst_size Size of the destination buffer in bytes.
+ * @return Returns the size of the file in bytes or -1 in case of an error.
  */
-int copy_file_to_mem(const char* filename, char* dst);
+int64_t copy_file_to_mem(const char* filename, char* dst,
+                         const size_t dst_size);
 
 /**
  * @brief Copies a block of memory to a file.
@@ -96,7 +495,7 @@ int copy_file_to_mem(const char* filename, char* dst);
  * @param size Size of the memory block to write in bytes.
  * @return 0 on success, 1 on error.
  */
-int copy_mem_to_file(const char* src, const char* filename, const int size);
+int copy_mem_to_file(const char* src, const char* filename, const size_t size);
 
 /**
  * @brief Loads input data from files into the model's buffers.
@@ -125,17 +524,33 @@ int process_outputs(const EnnModelId model_id, EnnBufferPtr* buffer_set,
                     NumberOfBuffersInfo buffer_info,
                     const std::vector<std::string>& goldens, float threshold);
 
+/**
+ * @brief Compares a buffer's data with golden data, reading the elements
+ * according to the buffer type.
+ *
+ * @param type Buffer type reported by EnnGetBufferInfoByIndex().
+ * @param control Pointer to golden data.
+ * @param test Pointer to buffer data.
+ * @param size Size of the data in bytes.
+ * @param threshold Threshold for comparison.
+ * @return Returns the statistics from compare_outputs().
+ */
+CompareStats compare_buffer(const uint32_t type, const void* control,
+                            const void* test, const size_t size,
+                            const float threshold);
+
 /**
  * @brief Compares a buffer's data with golden data and prints matching results.
  *
- * @tparam T Data type (e.g., float, uint8_t).
+ * @param type Buffer type reported by EnnGetBufferInfoByIndex().
  * @param control Pointer to golden data.
  * @param test Pointer to buffer data.
- * @param size Size of the data.
+ * @param size Size of the data in bytes.
  * @param threshold Threshold for comparison.
  */
-template <typename T>
-void golden_matching(void* control, void* test, int size, float threshold);
+void golden_matching(const uint32_t type, const void* control,
+                     const void* test, const size_t size,
+                     const float threshold);
 
 /**
  * @brief Parses command line arguments.
@@ -145,14 +560,18 @@ void golden_matching(void* control, void* test, int size, float threshold);
  *
  * @param argc The count of command line arguments.
  * @param argv The array of command line arguments.
- * @param model_name The name of the model to execute.
+ * @param model_names The models to execute, concurrently if more than one.
  * @param inputs The input data files.
  * @param goldens The golden (reference) files.
  * @param iteration The number of iterations to run the model.
  * @param force Whether to run the model without input data.
  * @param threshold The threshold value for model execution.
+ * @param benchmark The warmup, duration and report settings.
+ * @param dataset The manifest or input directory of a dataset sweep.
  */
-void parse_arguments(int argc, char** argv, std::string& model_name,
+void parse_arguments(int argc, char** argv,
+                     std::vector<std::string>& model_names,
                      std::vector<std::string>& inputs,
                      std::vector<std::string>& goldens, int& iteration,
-                     bool& force, float& threshold);
\ No newline at end of file
+                     bool& force, float& threshold,
+                     BenchmarkOptions& benchmark, DatasetOptions& dataset);
\ No newline at end of file
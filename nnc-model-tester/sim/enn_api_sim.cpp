@@ -0,0 +1,738 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+// Host implementation of the ENN public API. Models are described by a small
+// text file instead of a compiled NNC, executions take a configurable
+// synthetic latency and fill the outputs with a deterministic function of the
+// inputs, so that the tester and the sample apps' native code can run on a
+// Linux build machine.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "enn_api-public_ndk_v1.hpp"
+
+namespace {
+
+// Same values as BufferType of the model tester
+const struct {
+    const char *name;
+    uint32_t type;
+    uint32_t element_size;
+} BUFFER_TYPES[] = {
+    {"FLOAT32", 0, 4}, {"FLOAT16", 1, 2}, {"INT32", 2, 4},  {"UINT8", 3, 1},
+    {"INT64", 4, 8},   {"BOOL", 6, 1},    {"INT16", 7, 2},  {"INT8", 9, 1},
+    {"FLOAT64", 10, 8}, {"UINT64", 12, 8}, {"UINT32", 15, 4},
+};
+
+// Maximum number of buffer sets per model, like the framework's commit spaces
+const int MAX_SESSIONS = 16;
+
+typedef struct _SimTensor {
+    std::string label;
+    uint32_t n, height, width, channel;
+    uint32_t buffer_type;
+    uint32_t element_size;
+    uint32_t size;
+} SimTensor;
+
+typedef struct _SimSession {
+    std::vector<EnnBufferPtr> inputs;
+    std::vector<EnnBufferPtr> outputs;
+    bool committed = false;
+    std::future<EnnReturn> pending;
+} SimSession;
+
+typedef struct _SimModel {
+    std::vector<SimTensor> inputs;
+    std::vector<SimTensor> outputs;
+    int64_t latency_us = 1000;
+    int64_t jitter_us = 0;
+    bool compute = true;
+    uint64_t jitter_state;
+    std::mutex mutex;
+    SimSession sessions[MAX_SESSIONS];
+} SimModel;
+
+std::mutex g_mutex;
+bool g_initialized = false;
+EnnModelId g_next_model_id = 1;
+std::map<EnnModelId, std::shared_ptr<SimModel>> g_models;
+
+// Set from any thread and read by executions in flight
+std::atomic<uint32_t> g_preset_id(0);
+std::atomic<uint32_t> g_perf_config_id(0);
+std::atomic<uint32_t> g_perf_mode(ENN_PREF_MODE_BALANCED);
+std::atomic<uint32_t> g_time_out(0);
+std::atomic<uint32_t> g_priority(0);
+std::atomic<uint32_t> g_core_affinity(0);  // 0 lets executions use every core
+
+// Simulated NPU cores, executions wait for a free one
+std::mutex g_core_mutex;
+std::condition_variable g_core_freed;
+int g_busy_cores = 0;
+
+int env_int(const char *name, int fallback) {
+    const char *value = getenv(name);
+    return value ? atoi(value) : fallback;
+}
+
+double env_double(const char *name, double fallback) {
+    const char *value = getenv(name);
+    return value ? atof(value) : fallback;
+}
+
+int core_count() { return std::max(1, env_int("ENN_SIM_CORES", 2)); }
+
+int usable_cores() {
+    const uint32_t all = (1u << core_count()) - 1;
+    const uint32_t affinity = g_core_affinity;
+    const uint32_t mask = affinity ? affinity & all : all;
+    return __builtin_popcount(mask);
+}
+
+// Latency factor of each PerfModePreference value
+double perf_mode_scale(uint32_t perf_mode) {
+    switch (perf_mode) {
+        case ENN_PREF_MODE_LOW_POWER:
+            return 1.6;
+        case ENN_PREF_MODE_PERFORMANCE:
+            return 1.0;
+        case ENN_PREF_MODE_BOOST:
+            return 0.85;
+        default:
+            return 1.2;
+    }
+}
+
+// Parses "input|output <label> <n> <h> <w> <c> <type>", "latency_us <us>",
+// "jitter_us <us>" and "compute on|off" lines
+bool parse_model(std::istream &description, SimModel &model) {
+    std::string line;
+
+    while (std::getline(description, line)) {
+        std::stringstream fields(line);
+        std::string key;
+
+        if (!(fields >> key) || key[0] == '#') continue;
+
+        if (key == "input" || key == "output") {
+            SimTensor tensor;
+            std::string type;
+
+            if (!(fields >> tensor.label >> tensor.n >> tensor.height >>
+                  tensor.width >> tensor.channel >> type)) {
+                return false;
+            }
+
+            bool known = false;
+            for (const auto &buffer_type : BUFFER_TYPES) {
+                if (type == buffer_type.name) {
+                    tensor.buffer_type = buffer_type.type;
+                    tensor.element_size = buffer_type.element_size;
+                    known = true;
+                }
+            }
+            if (!known) return false;
+
+            tensor.size = tensor.n * tensor.height * tensor.width *
+                          tensor.channel * tensor.element_size;
+            (key == "input" ? model.inputs : model.outputs).push_back(tensor);
+        } else if (key == "latency_us") {
+            if (!(fields >> model.latency_us)) return false;
+        } else if (key == "jitter_us") {
+            if (!(fields >> model.jitter_us)) return false;
+        } else if (key == "compute") {
+            std::string value;
+            if (!(fields >> value)) return false;
+            model.compute = value != "off";
+        } else {
+            return false;
+        }
+    }
+
+    return !model.inputs.empty() && !model.outputs.empty();
+}
+
+EnnReturn register_model(std::istream &description, EnnModelId *model_id) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!g_initialized || !model_id) return ENN_RET_INVAL;
+
+    auto model = std::make_shared<SimModel>();
+    if (!parse_model(description, *model)) {
+        fprintf(stderr, "ENN simulator: invalid model description\n");
+        return ENN_RET_INVAL;
+    }
+
+    *model_id = g_next_model_id++;
+    model->jitter_state = *model_id * 0x9E3779B97F4A7C15ull;
+    g_models[*model_id] = model;
+
+    return ENN_RET_SUCCESS;
+}
+
+std::shared_ptr<SimModel> find_model(const EnnModelId model_id) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto model = g_models.find(model_id);
+
+    return model == g_models.end() ? nullptr : model->second;
+}
+
+SimSession *find_session(SimModel &model, const int session_id) {
+    return session_id >= 0 && session_id < MAX_SESSIONS
+               ? &model.sessions[session_id]
+               : nullptr;
+}
+
+EnnBufferPtr create_buffer(const uint32_t size) {
+    EnnBufferPtr buffer = new EnnBuffer;
+    buffer->va = calloc(1, std::max<uint32_t>(size, 1));
+    buffer->size = size;
+    buffer->offset = 0;
+
+    return buffer;
+}
+
+uint16_t float_to_half(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 112;
+    const uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent <= 0) return static_cast<uint16_t>(sign);
+    if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7C00);
+
+    return static_cast<uint16_t>(sign | (exponent << 10) | (mantissa >> 13));
+}
+
+// Writes an element holding the average of some input bytes
+void store_element(uint8_t *dst, const uint32_t buffer_type,
+                   const double average) {
+    switch (buffer_type) {
+        case 0: {
+            const float value = static_cast<float>(average / 255.0);
+            memcpy(dst, &value, sizeof(value));
+            break;
+        }
+        case 1: {
+            const uint16_t value =
+                float_to_half(static_cast<float>(average / 255.0));
+            memcpy(dst, &value, sizeof(value));
+            break;
+        }
+        case 10: {
+            const double value = average / 255.0;
+            memcpy(dst, &value, sizeof(value));
+            break;
+        }
+        case 9:
+            *reinterpret_cast<int8_t *>(dst) =
+                static_cast<int8_t>(static_cast<int>(average + 0.5) - 128);
+            break;
+        case 6:
+            *dst = average >= 128.0;
+            break;
+        default: {
+            // Integer types hold the rounded average in their low byte order
+            const uint64_t value = static_cast<uint64_t>(average + 0.5);
+            uint32_t size = 0;
+            for (const auto &type : BUFFER_TYPES) {
+                if (type.type == buffer_type) size = type.element_size;
+            }
+            memcpy(dst, &value, size);
+            break;
+        }
+    }
+}
+
+// Reference compute: element i of an output averages the i-th of as many
+// equal slices of all input bytes, so outputs follow the inputs and a golden
+// can be recorded once and checked on every run
+void compute_outputs(const SimModel &model, const SimSession &session) {
+    uint64_t total = 0;
+    for (const auto &input : session.inputs) total += input->size;
+
+    std::vector<const uint8_t *> bases;
+    std::vector<uint64_t> starts;
+    uint64_t start = 0;
+    for (const auto &input : session.inputs) {
+        bases.push_back(reinterpret_cast<const uint8_t *>(input->va));
+        starts.push_back(start);
+        start += input->size;
+    }
+
+    auto input_byte = [&](uint64_t index) -> uint8_t {
+        size_t layer = std::upper_bound(starts.begin(), starts.end(), index) -
+                       starts.begin() - 1;
+        return bases[layer][index - starts[layer]];
+    };
+
+    for (size_t layer = 0; layer < model.outputs.size(); layer++) {
+        const SimTensor &tensor = model.outputs[layer];
+        uint8_t *dst = reinterpret_cast<uint8_t *>(session.outputs[layer]->va);
+        const uint64_t count = tensor.size / tensor.element_size;
+
+        for (uint64_t idx = 0; idx < count; idx++) {
+            uint64_t begin = total * idx / count;
+            uint64_t end = std::max(total * (idx + 1) / count, begin + 1);
+            uint64_t sum = 0;
+
+            end = std::min(end, total);
+            for (uint64_t byte = begin; byte < end; byte++) {
+                sum += input_byte(byte);
+            }
+
+            const double average =
+                end > begin ? static_cast<double>(sum) / (end - begin) : 0.0;
+            store_element(dst + idx * tensor.element_size, tensor.buffer_type,
+                          average);
+        }
+    }
+}
+
+EnnReturn run_model(const std::shared_ptr<SimModel> &model,
+                    const int session_id) {
+    int64_t latency_us;
+    {
+        std::lock_guard<std::mutex> lock(model->mutex);
+        SimSession *session = find_session(*model, session_id);
+
+        if (!session || !session->committed) return ENN_RET_INVAL;
+
+        // xorshift keeps the jitter sequence identical between runs
+        uint64_t &state = model->jitter_state;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        const int64_t jitter =
+            model->jitter_us
+                ? static_cast<int64_t>(state % (2 * model->jitter_us + 1)) -
+                      model->jitter_us
+                : 0;
+        latency_us = static_cast<int64_t>(
+            (model->latency_us + jitter) * perf_mode_scale(g_perf_mode) *
+            env_double("ENN_SIM_LATENCY_SCALE", 1.0));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(g_core_mutex);
+        g_core_freed.wait(lock, [] { return g_busy_cores < usable_cores(); });
+        g_busy_cores++;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    if (model->compute) {
+        compute_outputs(*model, model->sessions[session_id]);
+    }
+    // The latency is a target, the reference compute runs inside of it
+    std::this_thread::sleep_until(start +
+                                  std::chrono::microseconds(latency_us));
+
+    {
+        std::lock_guard<std::mutex> lock(g_core_mutex);
+        g_busy_cores--;
+    }
+    g_core_freed.notify_all();
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn get_tensor_info(EnnBufferInfo *out_buf_info,
+                          const SimTensor &tensor) {
+    if (!out_buf_info) return ENN_RET_INVAL;
+
+    out_buf_info->is_able_to_update = false;
+    out_buf_info->n = tensor.n;
+    out_buf_info->width = tensor.width;
+    out_buf_info->height = tensor.height;
+    out_buf_info->channel = tensor.channel;
+    out_buf_info->size = tensor.size;
+    out_buf_info->buffer_type = tensor.buffer_type;
+    out_buf_info->label = tensor.label.c_str();
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn set_preference(std::atomic<uint32_t> &preference,
+                         const uint32_t val) {
+    preference = val;
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn get_preference(const std::atomic<uint32_t> &preference,
+                         uint32_t *val_ptr) {
+    if (!val_ptr) return ENN_RET_INVAL;
+
+    *val_ptr = preference;
+    return ENN_RET_SUCCESS;
+}
+
+}  // namespace
+
+namespace enn {
+namespace api {
+
+EnnReturn EnnInitialize(void) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_initialized = true;
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnDeinitialize(void) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_initialized = false;
+    g_models.clear();
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnOpenModel(const char *model_file, EnnModelId *model_id) {
+    if (!model_file) return ENN_RET_INVAL;
+
+    // A compiled NNC cannot be simulated, its description sits next to it
+    std::ifstream description(std::string(model_file) + ".sim");
+    if (!description) description.open(model_file);
+    if (!description) {
+        fprintf(stderr, "ENN simulator: cannot open %s(.sim)\n", model_file);
+        return ENN_RET_IO;
+    }
+
+    return register_model(description, model_id);
+}
+
+EnnReturn EnnOpenModelFromMemory(const char *va, const uint32_t size,
+                                 EnnModelId *model_id) {
+    if (!va) return ENN_RET_INVAL;
+
+    std::stringstream description(std::string(va, size));
+
+    return register_model(description, model_id);
+}
+
+EnnReturn EnnCloseModel(const EnnModelId model_id) {
+    std::shared_ptr<SimModel> model;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto found = g_models.find(model_id);
+
+        if (found == g_models.end()) return ENN_RET_INVAL;
+        model = found->second;
+        g_models.erase(found);
+    }
+
+    // Executions still in flight finish before the model goes away
+    for (auto &session : model->sessions) {
+        if (session.pending.valid()) session.pending.wait();
+    }
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnCreateBuffer(EnnBufferPtr *out, const uint32_t req_size,
+                          const bool /*is_cached*/) {
+    if (!out) return ENN_RET_INVAL;
+
+    *out = create_buffer(req_size);
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnAllocateAllBuffers(const EnnModelId model_id,
+                                EnnBufferPtr **out_buffers,
+                                NumberOfBuffersInfo *buf_info,
+                                const int session_id, const bool do_commit) {
+    auto model = find_model(model_id);
+    if (!model || !out_buffers || !buf_info) return ENN_RET_INVAL;
+
+    std::lock_guard<std::mutex> lock(model->mutex);
+    SimSession *session = find_session(*model, session_id);
+    if (!session) return ENN_RET_INVAL;
+
+    const size_t n_buf = model->inputs.size() + model->outputs.size();
+    EnnBufferPtr *buffers = new EnnBufferPtr[n_buf];
+
+    session->inputs.clear();
+    session->outputs.clear();
+    for (size_t idx = 0; idx < model->inputs.size(); idx++) {
+        buffers[idx] = create_buffer(model->inputs[idx].size);
+        session->inputs.push_back(buffers[idx]);
+    }
+    for (size_t idx = 0; idx < model->outputs.size(); idx++) {
+        buffers[model->inputs.size() + idx] =
+            create_buffer(model->outputs[idx].size);
+        session->outputs.push_back(buffers[model->inputs.size() + idx]);
+    }
+    session->committed = do_commit;
+
+    *out_buffers = buffers;
+    buf_info->n_in_buf = static_cast<uint32_t>(model->inputs.size());
+    buf_info->n_out_buf = static_cast<uint32_t>(model->outputs.size());
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnReleaseBuffers(EnnBufferPtr *buffers,
+                            const int32_t numOfBuffers) {
+    if (!buffers) return ENN_RET_INVAL;
+
+    for (int32_t idx = 0; idx < numOfBuffers; idx++) {
+        EnnReleaseBuffer(buffers[idx]);
+    }
+    delete[] buffers;
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnReleaseBuffer(EnnBufferPtr buffer) {
+    if (!buffer) return ENN_RET_INVAL;
+
+    free(buffer->va);
+    delete buffer;
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnGetBuffersInfo(NumberOfBuffersInfo *buffers_info,
+                            const EnnModelId model_id) {
+    auto model = find_model(model_id);
+    if (!model || !buffers_info) return ENN_RET_INVAL;
+
+    buffers_info->n_in_buf = static_cast<uint32_t>(model->inputs.size());
+    buffers_info->n_out_buf = static_cast<uint32_t>(model->outputs.size());
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnGetBufferInfoByIndex(EnnBufferInfo *out_buf_info,
+                                  const EnnModelId model_id,
+                                  const enn_buf_dir_e direction,
+                                  const uint32_t index) {
+    auto model = find_model(model_id);
+    if (!model || (direction != ENN_DIR_IN && direction != ENN_DIR_OUT)) {
+        return ENN_RET_INVAL;
+    }
+
+    const auto &tensors =
+        direction == ENN_DIR_IN ? model->inputs : model->outputs;
+    if (index >= tensors.size()) return ENN_RET_INVAL;
+
+    return get_tensor_info(out_buf_info, tensors[index]);
+}
+
+EnnReturn EnnGetBufferInfoByLabel(EnnBufferInfo *out_buf_info,
+                                  const EnnModelId model_id,
+                                  const char *label) {
+    auto model = find_model(model_id);
+    if (!model || !label) return ENN_RET_INVAL;
+
+    for (const auto *tensors : {&model->inputs, &model->outputs}) {
+        for (const auto &tensor : *tensors) {
+            if (tensor.label == label) {
+                return get_tensor_info(out_buf_info, tensor);
+            }
+        }
+    }
+
+    return ENN_RET_INVAL;
+}
+
+EnnReturn EnnSetBufferByIndex(const EnnModelId model_id,
+                              const enn_buf_dir_e direction,
+                              const uint32_t index, EnnBufferPtr buf,
+                              const int session_id) {
+    auto model = find_model(model_id);
+    if (!model || !buf) return ENN_RET_INVAL;
+
+    std::lock_guard<std::mutex> lock(model->mutex);
+    SimSession *session = find_session(*model, session_id);
+    if (!session) return ENN_RET_INVAL;
+
+    const auto &tensors =
+        direction == ENN_DIR_IN ? model->inputs : model->outputs;
+    auto &buffers =
+        direction == ENN_DIR_IN ? session->inputs : session->outputs;
+    if ((direction != ENN_DIR_IN && direction != ENN_DIR_OUT) ||
+        index >= tensors.size() || buf->size < tensors[index].size) {
+        return ENN_RET_INVAL;
+    }
+
+    buffers.resize(tensors.size(), nullptr);
+    buffers[index] = buf;
+    session->committed = false;
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnSetBufferByLabel(const EnnModelId model_id, const char *label,
+                              EnnBufferPtr buf, const int session_id) {
+    auto model = find_model(model_id);
+    if (!model || !label) return ENN_RET_INVAL;
+
+    for (uint32_t idx = 0; idx < model->inputs.size(); idx++) {
+        if (model->inputs[idx].label == label) {
+            return EnnSetBufferByIndex(model_id, ENN_DIR_IN, idx, buf,
+                                       session_id);
+        }
+    }
+    for (uint32_t idx = 0; idx < model->outputs.size(); idx++) {
+        if (model->outputs[idx].label == label) {
+            return EnnSetBufferByIndex(model_id, ENN_DIR_OUT, idx, buf,
+                                       session_id);
+        }
+    }
+
+    return ENN_RET_INVAL;
+}
+
+EnnReturn EnnBufferCommit(const EnnModelId model_id, const int session_id) {
+    auto model = find_model(model_id);
+    if (!model) return ENN_RET_INVAL;
+
+    std::lock_guard<std::mutex> lock(model->mutex);
+    SimSession *session = find_session(*model, session_id);
+    if (!session || session->inputs.size() != model->inputs.size() ||
+        session->outputs.size() != model->outputs.size()) {
+        return ENN_RET_INVAL;
+    }
+
+    for (const auto *buffers : {&session->inputs, &session->outputs}) {
+        for (const auto buffer : *buffers) {
+            if (!buffer) return ENN_RET_INVAL;
+        }
+    }
+    session->committed = true;
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnExecuteModel(const EnnModelId model_id, const int session_id) {
+    auto model = find_model(model_id);
+    if (!model) return ENN_RET_INVAL;
+
+    return run_model(model, session_id);
+}
+
+EnnReturn EnnExecuteModelAsync(const EnnModelId model_id,
+                               const int session_id) {
+    auto model = find_model(model_id);
+    if (!model) return ENN_RET_INVAL;
+
+    std::lock_guard<std::mutex> lock(model->mutex);
+    SimSession *session = find_session(*model, session_id);
+    if (!session || session->pending.valid()) return ENN_RET_INVAL;
+
+    session->pending =
+        std::async(std::launch::async, run_model, model, session_id);
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnExecuteModelWait(const EnnModelId model_id,
+                              const int session_id) {
+    auto model = find_model(model_id);
+    if (!model) return ENN_RET_INVAL;
+
+    std::future<EnnReturn> pending;
+    {
+        std::lock_guard<std::mutex> lock(model->mutex);
+        SimSession *session = find_session(*model, session_id);
+        if (!session || !session->pending.valid()) return ENN_RET_INVAL;
+        pending = std::move(session->pending);
+    }
+
+    return pending.get();
+}
+
+EnnReturn EnnSetPreferencePresetId(const uint32_t val) {
+    return set_preference(g_preset_id, val);
+}
+
+EnnReturn EnnSetPreferencePerfConfigId(const uint32_t val) {
+    return set_preference(g_perf_config_id, val);
+}
+
+EnnReturn EnnSetPreferencePerfMode(const uint32_t val) {
+    return set_preference(g_perf_mode, val);
+}
+
+EnnReturn EnnSetPreferenceTimeOut(const uint32_t val) {
+    return set_preference(g_time_out, val);
+}
+
+EnnReturn EnnSetPreferencePriority(const uint32_t val) {
+    return set_preference(g_priority, val);
+}
+
+EnnReturn EnnSetPreferenceCoreAffinity(const uint32_t val) {
+    // Masks without any simulated core are rejected like on the device
+    if (val && !(val & ((1u << core_count()) - 1))) {
+        return ENN_RET_NOT_SUPPORTED;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_core_mutex);
+        g_core_affinity = val;
+    }
+    g_core_freed.notify_all();
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnGetPreferencePresetId(uint32_t *val_ptr) {
+    return get_preference(g_preset_id, val_ptr);
+}
+
+EnnReturn EnnGetPreferencePerfConfigId(uint32_t *val_ptr) {
+    return get_preference(g_perf_config_id, val_ptr);
+}
+
+EnnReturn EnnGetPreferencePerfMode(uint32_t *val_ptr) {
+    return get_preference(g_perf_mode, val_ptr);
+}
+
+EnnReturn EnnGetPreferenceTimeOut(uint32_t *val_ptr) {
+    return get_preference(g_time_out, val_ptr);
+}
+
+EnnReturn EnnGetPreferencePriority(uint32_t *val_ptr) {
+    return get_preference(g_priority, val_ptr);
+}
+
+EnnReturn EnnGetPreferenceCoreAffinity(uint32_t *val_ptr) {
+    return get_preference(g_core_affinity, val_ptr);
+}
+
+EnnReturn EnnGetMetaInfo(const EnnMetaTypeId info_id,
+                         const EnnModelId /*model_id*/,
+                         char output_str[ENN_INFO_GRAPH_STR_LENGTH_MAX]) {
+    if (!output_str) return ENN_RET_INVAL;
+
+    snprintf(output_str, ENN_INFO_GRAPH_STR_LENGTH_MAX, "ENN simulator (%d)",
+             static_cast<int>(info_id));
+
+    return ENN_RET_SUCCESS;
+}
+
+EnnReturn EnnSetExecMsgAlwaysOn() { return ENN_RET_SUCCESS; }
+
+EnnReturn EnnSetExecMsgAlwaysOff() { return ENN_RET_SUCCESS; }
+
+}  // namespace api
+}  // namespace enn
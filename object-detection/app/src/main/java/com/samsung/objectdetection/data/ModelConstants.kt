@@ -20,5 +20,10 @@ object ModelConstants {
     const val OUTPUT_SIZE_W = 25200
     const val OUTPUT_SIZE_H = 85
 
+    val NMS_METHOD = NmsMethod.GREEDY
+
+    const val NMS_IOU_THRESHOLD = 0.45F
+    const val NMS_MAX_DETECTIONS = 100
+
     const val LABEL_FILE = "coco.txt"
 }
\ No newline at end of file
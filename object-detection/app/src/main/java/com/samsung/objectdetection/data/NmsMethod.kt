@@ -0,0 +1,9 @@
+// Copyright (c) 2023 Samsung Electronics Co. LTD. Released under the MIT License.
+
+package com.samsung.objectdetection.data
+
+enum class NmsMethod {
+    NONE,   // Keep every box above the threshold
+    GREEDY, // Suppress overlapping boxes in exact score order
+    GRID,   // Approximate score order with spatial buckets, faster on dense outputs
+}
\ No newline at end of file
@@ -7,7 +7,6 @@ import android.content.res.AssetFileDescriptor
 import android.graphics.Bitmap
 import android.os.SystemClock
 import com.samsung.perfcompare.data.DataType
-import com.samsung.perfcompare.data.LayerType
 import com.samsung.perfcompare.data.ModelConstants
 import com.samsung.perfcompare.enn_type.BufferSetInfo
 import org.tensorflow.lite.Interpreter
@@ -29,15 +28,36 @@ class ModelExecutor(
     val context: Context,
     val executorListener: ExecutorListener?
 ) {
-    private external fun ennInitialize()
+    private external fun ennInitialize(preferencesPath: String)
     private external fun ennDeinitialize()
     private external fun ennOpenModel(filename: String): Long
     private external fun ennCloseModel(modelId: Long)
     private external fun ennAllocateAllBuffers(modelId: Long): BufferSetInfo
     private external fun ennReleaseBuffers(bufferSet: Long, bufferSize: Int)
     private external fun ennExecute(modelId: Long)
-    private external fun ennMemcpyHostToDevice(bufferSet: Long, layerNumber: Int, data: ByteArray)
-    private external fun ennMemcpyDeviceToHost(bufferSet: Long, layerNumber: Int): ByteArray
+    private external fun ennBufferView(bufferSet: Long, layerNumber: Int): ByteBuffer
+    private external fun ennConvertBitmapToFloat(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertBitmapToUInt8(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertFrameToFloat(
+        bufferSet: Long, layerNumber: Int, frame: ByteBuffer, frameWidth: Int, frameHeight: Int,
+        rowStride: Int, rotation: Int, width: Int, height: Int, layerType: Int, offset: Float,
+        scale: Float
+    )
+    private external fun ennConvertFrameToUInt8(
+        bufferSet: Long, layerNumber: Int, frame: ByteBuffer, frameWidth: Int, frameHeight: Int,
+        rowStride: Int, rotation: Int, width: Int, height: Int, layerType: Int, offset: Float,
+        scale: Float
+    )
+    private external fun ennSelectTopK(
+        output: ByteBuffer, dataType: Int, count: Int, k: Int, threshold: Float,
+        offset: Float, scale: Float, dequantize: FloatArray
+    ): FloatArray
 
     private var modelId: Long = 0
     private var bufferSet: Long = 0
@@ -55,8 +75,8 @@ class ModelExecutor(
     }
 
     private fun setupENN() {
-        // Initialize ENN
-        ennInitialize()
+        // Initialize ENN with the preferences tuned by enn_nnc_model_tester, if shipped
+        ennInitialize(copyPreferencesFromAssetsToInternalStorage())
 
         // Open model
         val fileAbsoluteDirectory = File(context.filesDir, NNC_MODEL_NAME).absolutePath
@@ -79,42 +99,45 @@ class ModelExecutor(
     }
 
     fun process(image: Bitmap) {
+        process { bufferSet -> preProcess(image, bufferSet) }
+    }
+
+    // Camera frame variant of process(), see preProcessFrame()
+    fun process(
+        frame: ByteBuffer, frameWidth: Int, frameHeight: Int, rowStride: Int, rotation: Int
+    ) {
+        process { bufferSet ->
+            preProcessFrame(frame, frameWidth, frameHeight, rowStride, rotation, bufferSet)
+        }
+    }
+
+    private fun process(writeInput: (Long) -> Unit) {
         // Inference with ENN
-        // Convert Input
-        val inputData = preProcess(image)
+        // Convert Input into the ENN Input Buffer
+        writeInput(bufferSet)
+        val inputData = ennBufferView(bufferSet, 0)
         // Execute
         var inferenceTimeENN = SystemClock.uptimeMillis()
-        val outputENN = executeENN(inputData)
+        val outputENN = executeENN()
         inferenceTimeENN = SystemClock.uptimeMillis() - inferenceTimeENN
 
 
         // Inference with TFLite
-        // Convert Input
-        val inputTFLite = ByteBuffer.allocate(inputData.size)
-        inputTFLite.put(inputData)
-        inputTFLite.rewind()
+        // The ENN input buffer is a direct ByteBuffer and is fed to TFLite as is
         var output = when (OUTPUT_DATA_TYPE) {
-            DataType.FLOAT32 -> ByteBuffer.allocate(OUTPUT_SIZE_W * 4)
-            DataType.UINT8 -> ByteBuffer.allocate(OUTPUT_SIZE_W)
+            DataType.FLOAT32 -> ByteBuffer.allocateDirect(OUTPUT_SIZE_W * 4)
+            DataType.UINT8 -> ByteBuffer.allocateDirect(OUTPUT_SIZE_W)
             else -> {
                 throw IllegalArgumentException("Unsupported input data type: ${OUTPUT_DATA_TYPE}")
             }
         }
         // Execute
         var inferenceTimeTFLite = SystemClock.uptimeMillis()
-        output = executeTFLite(inputTFLite, output)
+        output = executeTFLite(inputData, output)
         inferenceTimeTFLite = SystemClock.uptimeMillis() - inferenceTimeTFLite
         // Convert Output
-        val byteArray = when (OUTPUT_DATA_TYPE) {
-            DataType.FLOAT32 -> ByteArray(OUTPUT_SIZE_W * 4)
-            DataType.UINT8 -> ByteArray(OUTPUT_SIZE_W)
-            else -> {
-                throw IllegalArgumentException("Unsupported input data type: ${OUTPUT_DATA_TYPE}")
-            }
-        }
         output.rewind()
-        output.get(byteArray)
-        val outputTFLite = byteArray
+        val outputTFLite = output
 
         executorListener?.onResults(
             postProcess(outputENN),
@@ -125,14 +148,12 @@ class ModelExecutor(
         )
     }
 
-    private fun executeENN(input: ByteArray): ByteArray {
-        // Copy Input Data
-        ennMemcpyHostToDevice(bufferSet, 0, input)
+    private fun executeENN(): ByteBuffer {
         // Execute
         ennExecute(modelId)
 
-        // Copy Output Data
-        return ennMemcpyDeviceToHost(bufferSet, nInBuffer)
+        // Map Output Data
+        return ennBufferView(bufferSet, nInBuffer)
     }
 
     private fun executeTFLite(input: ByteBuffer, output: ByteBuffer): ByteBuffer {
@@ -150,60 +171,71 @@ class ModelExecutor(
         ennDeinitialize()
     }
 
-    private fun preProcess(image: Bitmap): ByteArray {
-        val byteArray = when (INPUT_DATA_TYPE) {
+    // Writes the converted image straight into the ENN input buffer
+    private fun preProcess(image: Bitmap, bufferSet: Long) {
+        when (INPUT_DATA_TYPE) {
             DataType.UINT8 -> {
-                convertBitmapToUByteArray(image, INPUT_DATA_LAYER).asByteArray()
+                ennConvertBitmapToUInt8(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             DataType.FLOAT32 -> {
-                val data = convertBitmapToFloatArray(image, INPUT_DATA_LAYER)
-                val byteBuffer = ByteBuffer.allocate(data.size * Float.SIZE_BYTES)
-                byteBuffer.order(ByteOrder.nativeOrder())
-                byteBuffer.asFloatBuffer().put(data)
-                byteBuffer.array()
+                ennConvertBitmapToFloat(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             else -> {
                 throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
         }
-
-        return byteArray
     }
 
-    private fun postProcess(modelOutput: ByteArray): Map<String, Float> {
-        val output = when (OUTPUT_DATA_TYPE) {
+    // Rotates, scales and center crops the camera frame straight into the ENN input buffer,
+    // in one native pass over its RGBA_8888 plane
+    private fun preProcessFrame(
+        frame: ByteBuffer, frameWidth: Int, frameHeight: Int, rowStride: Int, rotation: Int,
+        bufferSet: Long
+    ) {
+        when (INPUT_DATA_TYPE) {
             DataType.UINT8 -> {
-                modelOutput.asUByteArray().mapIndexed { index, value ->
-                    labelList[index] to dequantizedValues[((value.toInt()
-                            - OUTPUT_CONVERSION_OFFSET)
-                            / OUTPUT_CONVERSION_SCALE).toInt()]
-                }.filter { it.second >= threshold }.sortedByDescending { it.second }.toMap()
+                ennConvertFrameToUInt8(
+                    bufferSet, 0, frame, frameWidth, frameHeight, rowStride, rotation,
+                    INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             DataType.FLOAT32 -> {
-                val byteBuffer = ByteBuffer.wrap(modelOutput).order(ByteOrder.nativeOrder())
-                val floatBuffer = byteBuffer.asFloatBuffer()
-                val data = FloatArray(floatBuffer.remaining())
-
-                floatBuffer.get(data)
-                data.mapIndexed { index, value ->
-                    labelList[index] to ((value
-                            - OUTPUT_CONVERSION_OFFSET)
-                            / OUTPUT_CONVERSION_SCALE)
-                }.filter { it.second >= threshold }.sortedByDescending { it.second }.toMap()
+                ennConvertFrameToFloat(
+                    bufferSet, 0, frame, frameWidth, frameHeight, rowStride, rotation,
+                    INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             else -> {
-                throw IllegalArgumentException("Unsupported output data type: ${OUTPUT_DATA_TYPE}")
+                throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
         }
+    }
 
-        return output
+    private fun postProcess(modelOutput: ByteBuffer): Map<String, Float> {
+        // index, score pairs of the best classes, dequantized only for the survivors
+        val selected = ennSelectTopK(
+            modelOutput, OUTPUT_DATA_TYPE.ordinal, OUTPUT_SIZE_W, TOP_K, threshold,
+            OUTPUT_CONVERSION_OFFSET, OUTPUT_CONVERSION_SCALE, dequantizedValues
+        )
+
+        return (selected.indices step 2).associate { i ->
+            labelList[selected[i].toInt()] to selected[i + 1]
+        }
     }
 
-    private fun calculateSNR(controlByteData: ByteArray, testByteData: ByteArray): Float {
+    private fun calculateSNR(controlByteData: ByteBuffer, testByteData: ByteBuffer): Float {
         val controlData = convertOutputByteToFloatArray(controlByteData)
         val testData = convertOutputByteToFloatArray(testByteData)
 
@@ -220,96 +252,8 @@ class ModelExecutor(
         return 10 * log10(signalPower / noisePower)
     }
 
-    private fun convertBitmapToUByteArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): UByteArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
-        )
-
-        val uByteArray = UByteArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
-        } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            uByteArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-        }
-
-        return uByteArray
-    }
-
-    private fun convertBitmapToFloatArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): FloatArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
-        )
-
-        val floatArray = FloatArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
-        } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            floatArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-        }
-
-        return floatArray
-    }
-
     private fun convertOutputByteToFloatArray(
-        modelOutput: ByteArray
+        modelOutput: ByteBuffer
     ): FloatArray {
         return when (OUTPUT_DATA_TYPE) {
             DataType.UINT8 -> {
@@ -317,7 +261,7 @@ class ModelExecutor(
             }
 
             DataType.FLOAT32 -> {
-                val byteBuffer = ByteBuffer.wrap(modelOutput).order(ByteOrder.nativeOrder())
+                val byteBuffer = modelOutput.order(ByteOrder.nativeOrder())
                 val floatBuffer = byteBuffer.asFloatBuffer()
                 val floatArray = FloatArray(floatBuffer.remaining())
 
@@ -331,6 +275,21 @@ class ModelExecutor(
         }
     }
 
+    private fun ByteBuffer.toUByteArray(): UByteArray =
+        ByteArray(remaining()).also { duplicate().get(it) }.asUByteArray()
+
+    // Returns the path of the preferences file, which only exists if the app ships one
+    private fun copyPreferencesFromAssetsToInternalStorage(): String {
+        val preferencesFile = File(context.filesDir, PREFERENCES_FILE)
+
+        if (context.assets.list("")?.contains(PREFERENCES_FILE) == true) {
+            copyNNCFromAssetsToInternalStorage(PREFERENCES_FILE)
+        } else {
+            preferencesFile.delete()
+        }
+        return preferencesFile.absolutePath
+    }
+
     private fun copyNNCFromAssetsToInternalStorage(filename: String) {
         try {
             val inputStream = context.assets.open(filename)
@@ -381,7 +340,7 @@ class ModelExecutor(
 
     companion object {
         var labelList: List<String> = mutableListOf()
-        val dequantizedValues = List(256) { it.toFloat() * 0.00390625F }
+        val dequantizedValues = FloatArray(256) { it.toFloat() * 0.00390625F }
 
         const val NNC_MODEL_NAME = ModelConstants.NNC_MODEL_NAME
         const val TFLITE_MODEL_NAME = ModelConstants.TFLITE_MODEL_NAME
@@ -391,7 +350,6 @@ class ModelExecutor(
 
         private const val INPUT_SIZE_W = ModelConstants.INPUT_SIZE_W
         private const val INPUT_SIZE_H = ModelConstants.INPUT_SIZE_H
-        private const val INPUT_SIZE_C = ModelConstants.INPUT_SIZE_C
 
         private const val INPUT_CONVERSION_SCALE = ModelConstants.INPUT_CONVERSION_SCALE
         private const val INPUT_CONVERSION_OFFSET = ModelConstants.INPUT_CONVERSION_OFFSET
@@ -406,5 +364,11 @@ class ModelExecutor(
         private const val OUTPUT_CONVERSION_OFFSET = ModelConstants.OUTPUT_CONVERSION_OFFSET
 
         private const val LABEL_FILE = ModelConstants.LABEL_FILE
+
+        // Number of labels shown by the fragments
+        private const val TOP_K = 3
+
+        // Written by enn_nnc_model_tester --sweep-preferences
+        private const val PREFERENCES_FILE = "enn_preferences.cfg"
     }
 }
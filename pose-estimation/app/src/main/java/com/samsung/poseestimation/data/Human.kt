@@ -52,13 +52,14 @@ data class Human(
     var score: Float = 0F,
 ) {
     companion object {
-        fun fromOutput(output: Array<FloatArray>): Human {
+        // output holds x, y, score for each keypoint
+        fun fromOutput(output: FloatArray): Human {
             val keyPoints = mutableListOf<KeyPoint>()
             var totalScore = 0F
 
-            for (point in output) {
-                val (x, y, score) = point
-                keyPoints.add(KeyPoint(PointF(x, y), score))
+            for (i in output.indices step 3) {
+                val score = output[i + 2]
+                keyPoints.add(KeyPoint(PointF(output[i], output[i + 1]), score))
                 totalScore += score
             }
 
@@ -5,19 +5,14 @@ package com.samsung.poseestimation.executor
 import android.content.Context
 import android.graphics.Bitmap
 import android.os.SystemClock
-import com.samsung.poseestimation.data.BodyPart
 import com.samsung.poseestimation.data.DataType
 import com.samsung.poseestimation.data.Human
-import com.samsung.poseestimation.data.LayerType
 import com.samsung.poseestimation.data.ModelConstants
 import com.samsung.poseestimation.enn_type.BufferSetInfo
 import java.io.File
 import java.io.FileOutputStream
 import java.io.IOException
 import java.nio.ByteBuffer
-import java.nio.ByteOrder
-import kotlin.math.exp
-import kotlin.math.max
 
 
 @Suppress("IMPLICIT_CAST_TO_ANY")
@@ -27,21 +22,56 @@ class ModelExecutor(
     val context: Context,
     val executorListener: ExecutorListener?
 ) {
-    private external fun ennInitialize()
+    private external fun ennInitialize(preferencesPath: String)
     private external fun ennDeinitialize()
     private external fun ennOpenModel(filename: String): Long
     private external fun ennCloseModel(modelId: Long)
     private external fun ennAllocateAllBuffers(modelId: Long): BufferSetInfo
     private external fun ennReleaseBuffers(bufferSet: Long, bufferSize: Int)
     private external fun ennExecute(modelId: Long)
-    private external fun ennMemcpyHostToDevice(bufferSet: Long, layerNumber: Int, data: ByteArray)
-    private external fun ennMemcpyDeviceToHost(bufferSet: Long, layerNumber: Int): ByteArray
+    private external fun ennBufferView(bufferSet: Long, layerNumber: Int): ByteBuffer
+    private external fun ennConvertBitmapToFloat(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertBitmapToUInt8(
+        bufferSet: Long, layerNumber: Int, image: Bitmap, width: Int, height: Int,
+        layerType: Int, offset: Float, scale: Float
+    )
+    private external fun ennConvertFrameToFloat(
+        bufferSet: Long, layerNumber: Int, frame: ByteBuffer, frameWidth: Int, frameHeight: Int,
+        rowStride: Int, rotation: Int, width: Int, height: Int, layerType: Int, offset: Float,
+        scale: Float
+    )
+    private external fun ennConvertFrameToUInt8(
+        bufferSet: Long, layerNumber: Int, frame: ByteBuffer, frameWidth: Int, frameHeight: Int,
+        rowStride: Int, rotation: Int, width: Int, height: Int, layerType: Int, offset: Float,
+        scale: Float
+    )
+    private external fun ennDecodePose(
+        heatmap: ByteBuffer, offsets: ByteBuffer, dataType: Int,
+        rows: Int, cols: Int, keypoints: Int, inputWidth: Int, inputHeight: Int
+    ): FloatArray
+    private external fun ennCreateBufferRing(modelId: Long, depth: Int): Long
+    private external fun ennRingBufferSet(bufferRing: Long, slot: Int): Long
+    private external fun ennRingExecuteAsync(bufferRing: Long, slot: Int)
+    private external fun ennRingWait(bufferRing: Long, slot: Int): Long
+    private external fun ennReleaseBufferRing(bufferRing: Long)
 
     private var modelId: Long = 0
     private var bufferSet: Long = 0
     private var nInBuffer: Int = 0
     private var nOutBuffer: Int = 0
 
+    // Created on the first processStream() call, 0 if the sessions could not be allocated
+    private var bufferRing: Long? = null
+    private var ringHead: Int = 0
+    private var ringInFlight: Int = 0
+
+    // Set by closeENN(), after which processStream() drops frames
+    @Volatile
+    private var closed = false
+
     init {
         System.loadLibrary("enn_jni")
         copyNNCFromAssetsToInternalStorage(MODEL_NAME)
@@ -49,8 +79,8 @@ class ModelExecutor(
     }
 
     private fun setupENN() {
-        // Initialize ENN
-        ennInitialize()
+        // Initialize ENN with the preferences tuned by enn_nnc_model_tester, if shipped
+        ennInitialize(copyPreferencesFromAssetsToInternalStorage())
 
         // Open model
         val fileAbsoluteDirectory = File(context.filesDir, MODEL_NAME).absolutePath
@@ -64,25 +94,97 @@ class ModelExecutor(
     }
 
     fun process(image: Bitmap) {
-        // Process Image to Input Byte Array
-        val input = preProcess(image)
-        // Copy Input Data
-        ennMemcpyHostToDevice(bufferSet, 0, input)
+        process { bufferSet -> preProcess(image, bufferSet) }
+    }
+
+    private fun process(writeInput: (Long) -> Unit) {
+        // Process Image into the Input Buffer
+        writeInput(bufferSet)
 
         var inferenceTime = SystemClock.uptimeMillis()
         // Model execute
         ennExecute(modelId)
         inferenceTime = SystemClock.uptimeMillis() - inferenceTime
-        // Copy Output Data
-        val heatmapModelOutput = ennMemcpyDeviceToHost(bufferSet, 3)
-        val offsetModelOutput = ennMemcpyDeviceToHost(bufferSet, 4)
+        // Map Output Data
+        val heatmapModelOutput = ennBufferView(bufferSet, 3)
+        val offsetModelOutput = ennBufferView(bufferSet, 4)
+
+        executorListener?.onResults(
+            postProcess(heatmapModelOutput, offsetModelOutput), inferenceTime
+        )
+    }
+
+    // Pipelined variant of process() for camera streams: the input of this frame is
+    // written to a free session while the previous frame still executes, so results
+    // are delivered BUFFER_RING_DEPTH - 1 frames late. The frame is read before this returns,
+    // see preProcessFrame().
+    fun processStream(
+        frame: ByteBuffer, frameWidth: Int, frameHeight: Int, rowStride: Int, rotation: Int
+    ) {
+        if (closed) {
+            return
+        }
+
+        val writeInput = { bufferSet: Long ->
+            preProcessFrame(frame, frameWidth, frameHeight, rowStride, rotation, bufferSet)
+        }
+        val ring = bufferRing ?: ennCreateBufferRing(modelId, BUFFER_RING_DEPTH).also {
+            bufferRing = it
+        }
+        if (ring == 0L) {
+            process(writeInput)
+            return
+        }
+
+        val slot = ringHead
+        // Process Image into the Input Buffer
+        writeInput(ennRingBufferSet(ring, slot))
+        // Model execute
+        ennRingExecuteAsync(ring, slot)
+        ringHead = (slot + 1) % BUFFER_RING_DEPTH
+        ringInFlight++
+
+        // Once every session is in flight, the oldest one is the next to be filled
+        if (ringInFlight == BUFFER_RING_DEPTH) {
+            collectStream(ring, ringHead)
+        }
+    }
+
+    private fun collectStream(ring: Long, slot: Int) {
+        // Time from submission to completion of the frame, measured natively so that it
+        // excludes the wait for the frame that collects it
+        val inferenceTime = ennRingWait(ring, slot)
+        ringInFlight--
+        if (inferenceTime < 0) {
+            return
+        }
+        // Map Output Data
+        val heatmapModelOutput = ennBufferView(ennRingBufferSet(ring, slot), 3)
+        val offsetModelOutput = ennBufferView(ennRingBufferSet(ring, slot), 4)
 
         executorListener?.onResults(
             postProcess(heatmapModelOutput, offsetModelOutput), inferenceTime
         )
     }
 
+    // Must run on the thread that calls processStream(), after its last call, so that the
+    // sessions are not released while a frame uses them
     fun closeENN() {
+        if (closed) {
+            return
+        }
+        closed = true
+
+        // Deliver the results of frames still in flight, then release the streaming sessions
+        bufferRing?.takeIf { it != 0L }?.let { ring ->
+            while (ringInFlight > 0) {
+                // Oldest session in flight
+                val slot = (ringHead - ringInFlight + BUFFER_RING_DEPTH) % BUFFER_RING_DEPTH
+                collectStream(ring, slot)
+            }
+            ennReleaseBufferRing(ring)
+        }
+        bufferRing = null
         // Release a buffer array
         ennReleaseBuffers(bufferSet, nInBuffer + nOutBuffer)
         // Close a Model and Free all resources
@@ -91,245 +193,84 @@ class ModelExecutor(
         ennDeinitialize()
     }
 
-    private fun preProcess(image: Bitmap): ByteArray {
-        val byteArray = when (INPUT_DATA_TYPE) {
+    // Writes the converted image straight into the ENN input buffer
+    private fun preProcess(image: Bitmap, bufferSet: Long) {
+        when (INPUT_DATA_TYPE) {
             DataType.UINT8 -> {
-                convertBitmapToUByteArray(image, INPUT_DATA_LAYER).asByteArray()
+                ennConvertBitmapToUInt8(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             DataType.FLOAT32 -> {
-                val data = convertBitmapToFloatArray(image, INPUT_DATA_LAYER)
-                val byteBuffer = ByteBuffer.allocate(data.size * Float.SIZE_BYTES)
-                byteBuffer.order(ByteOrder.nativeOrder())
-                byteBuffer.asFloatBuffer().put(data)
-                byteBuffer.array()
+                ennConvertBitmapToFloat(
+                    bufferSet, 0, image, INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
             }
 
             else -> {
                 throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
         }
-
-        return byteArray
-    }
-
-    private fun postProcess(heatmapModelOutput: ByteArray, offsetModelOutput: ByteArray): Human {
-        val heatmap = convertModelOutputToArray(
-            heatmapModelOutput, arrayOf(
-                HEATMAP_SIZE_W, HEATMAP_SIZE_H, HEATMAP_SIZE_C
-            ), HEATMAP_DATA_TYPE
-        )
-        val offset = convertModelOutputToArray(
-            offsetModelOutput, arrayOf(
-                OFFSET_SIZE_W, OFFSET_SIZE_H, OFFSET_SIZE_C
-            ), OFFSET_DATA_TYPE
-        )
-
-        return Human.fromOutput(postProcessModelOutputs(heatmap, offset))
     }
 
-    private fun postProcessModelOutputs(
-        heatmaps: Array<Array<FloatArray>>, offsets: Array<Array<FloatArray>>
-    ): Array<FloatArray> {
-        val numKeypoints = heatmaps[0][0].size
-        val keypointPositions = Array(numKeypoints) { findMaxInHeatmap(heatmaps, it) }
-        val (yCoords, xCoords, confidenceScores) = computeCoordinatesAndConfidence(
-            keypointPositions, offsets, heatmaps
-        )
+    // Rotates, scales and center crops the camera frame straight into the ENN input buffer,
+    // in one native pass over its RGBA_8888 plane
+    private fun preProcessFrame(
+        frame: ByteBuffer, frameWidth: Int, frameHeight: Int, rowStride: Int, rotation: Int,
+        bufferSet: Long
+    ) {
+        when (INPUT_DATA_TYPE) {
+            DataType.UINT8 -> {
+                ennConvertFrameToUInt8(
+                    bufferSet, 0, frame, frameWidth, frameHeight, rowStride, rotation,
+                    INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
+            }
 
-        return enumValues<BodyPart>().mapIndexed { idx, _ ->
-            floatArrayOf(xCoords[idx].toFloat(), yCoords[idx].toFloat(), confidenceScores[idx])
-        }.toTypedArray()
-    }
+            DataType.FLOAT32 -> {
+                ennConvertFrameToFloat(
+                    bufferSet, 0, frame, frameWidth, frameHeight, rowStride, rotation,
+                    INPUT_SIZE_W, INPUT_SIZE_H,
+                    INPUT_DATA_LAYER.ordinal, INPUT_CONVERSION_OFFSET, INPUT_CONVERSION_SCALE
+                )
+            }
 
-    private fun findMaxInHeatmap(
-        heatmaps: Array<Array<FloatArray>>,
-        keypoint: Int
-    ): Pair<Int, Int> =
-        heatmaps.withIndex().flatMap { (row, heatmapRow) ->
-            heatmapRow.withIndex().map { (col, heatmapCol) ->
-                Triple(heatmapCol[keypoint], row, col)
+            else -> {
+                throw IllegalArgumentException("Unsupported input data type: ${INPUT_DATA_TYPE}")
             }
-        }.maxByOrNull { it.first }?.let { Pair(it.second, it.third) }
-            ?: Pair(0, 0)
-
-    private fun computeCoordinatesAndConfidence(
-        keypointPositions: Array<Pair<Int, Int>>,
-        offsets: Array<Array<FloatArray>>,
-        heatmaps: Array<Array<FloatArray>>
-    ): Triple<IntArray, IntArray, FloatArray> {
-        val height = heatmaps.size
-        val width = heatmaps[0].size
-        val numKeypoints = heatmaps[0][0].size
-        val yCoords = IntArray(numKeypoints)
-        val xCoords = IntArray(numKeypoints)
-        val confidenceScores = FloatArray(numKeypoints)
-
-        val cropDimensions = computeCropDimensions(INPUT_SIZE_W, INPUT_SIZE_H)
-
-        keypointPositions.forEachIndexed { idx,  (y, x) ->
-            yCoords[idx] = computeCoordinate(
-                axisPosition = y,
-                axisLength = height,
-                imageSize = INPUT_SIZE_H,
-                offset = offsets[y][x][idx],
-                cropDimension = cropDimensions.first
-            )
-            xCoords[idx] = computeCoordinate(
-                axisPosition = x,
-                axisLength = width,
-                imageSize = INPUT_SIZE_W,
-                offset = offsets[y][x][idx + numKeypoints],
-                cropDimension = cropDimensions.second
-            )
-            confidenceScores[idx] = sigmoid(heatmaps[y][x][idx])
         }
-
-        return Triple(yCoords, xCoords, confidenceScores)
-    }
-
-    private fun computeCropDimensions(width: Int, height: Int): Pair<Float, Float> {
-        val cropWidth = if (width > height) 0F else (height - width).toFloat()
-        val cropHeight = if (width > height) (width - height).toFloat() else 0F
-        return cropHeight to cropWidth
-    }
-
-    private fun computeCoordinate(
-        axisPosition: Int,
-        axisLength: Int,
-        imageSize: Int,
-        offset: Float,
-        cropDimension: Float
-    ): Int {
-        val scale = max(INPUT_SIZE_W, INPUT_SIZE_H).toFloat()
-        val coordinate = axisPosition / (axisLength - 1).toFloat() * imageSize + offset
-        return ((coordinate * scale / imageSize) - cropDimension / 2).toInt()
     }
 
-    private fun convertBitmapToUByteArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): UByteArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
-        )
-
-        val uByteArray = UByteArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
-        } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            uByteArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
-            uByteArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE).toInt().toUByte()
+    private fun postProcess(heatmapModelOutput: ByteBuffer, offsetModelOutput: ByteBuffer): Human {
+        if (HEATMAP_DATA_TYPE != OFFSET_DATA_TYPE) {
+            throw IllegalArgumentException(
+                "Unsupported output data types: ${HEATMAP_DATA_TYPE}, ${OFFSET_DATA_TYPE}"
+            )
         }
 
-        return uByteArray
-    }
-
-    private fun convertBitmapToFloatArray(
-        image: Bitmap, layerType: Enum<LayerType> = LayerType.HWC
-    ): FloatArray {
-        val totalPixels = INPUT_SIZE_H * INPUT_SIZE_W
-        val pixels = IntArray(totalPixels)
-
-        image.getPixels(
-            pixels,
-            0,
-            INPUT_SIZE_W,
-            0,
-            0,
-            INPUT_SIZE_W,
-            INPUT_SIZE_H
+        // x, y, score for each keypoint, decoded in place from the output buffers
+        return Human.fromOutput(
+            ennDecodePose(
+                heatmapModelOutput, offsetModelOutput, HEATMAP_DATA_TYPE.ordinal,
+                HEATMAP_SIZE_W, HEATMAP_SIZE_H, HEATMAP_SIZE_C, INPUT_SIZE_W, INPUT_SIZE_H
+            )
         )
-
-        val floatArray = FloatArray(totalPixels * INPUT_SIZE_C)
-        val offset: IntArray
-        val stride: Int
-
-        if (layerType == LayerType.CHW) {
-            offset = intArrayOf(0, totalPixels, 2 * totalPixels)
-            stride = 1
-        } else {
-            offset = intArrayOf(0, 1, 2)
-            stride = 3
-        }
-
-        for (i in 0 until totalPixels) {
-            val color = pixels[i]
-            floatArray[i * stride + offset[0]] = ((((color shr 16) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[1]] = ((((color shr 8) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-            floatArray[i * stride + offset[2]] = ((((color shr 0) and 0xFF)
-                    - INPUT_CONVERSION_OFFSET)
-                    / INPUT_CONVERSION_SCALE)
-        }
-
-        return floatArray
-    }
-
-    private fun convertModelOutputToArray(
-        modelOutput: ByteArray, shapeArray: Array<Int>, dataType: DataType
-    ): Array<Array<FloatArray>> {
-        val output = convertOutputByteToFloatArray(modelOutput, dataType)
-
-        return Array(shapeArray[0]) { i ->
-            Array(shapeArray[1]) { j ->
-                FloatArray(shapeArray[2]) { k ->
-                    output[(i * shapeArray[1] * shapeArray[2]) + (j * shapeArray[2]) + k]
-                }
-            }
-        }
     }
 
-    private fun convertOutputByteToFloatArray(
-        modelOutput: ByteArray,
-        dataType: DataType
-    ): FloatArray {
-        return when (dataType) {
-            DataType.UINT8 -> {
-                modelOutput.toUByteArray().map { it.toFloat() }.toFloatArray()
-            }
-
-            DataType.FLOAT32 -> {
-                val byteBuffer = ByteBuffer.wrap(modelOutput).order(ByteOrder.nativeOrder())
-                val floatBuffer = byteBuffer.asFloatBuffer()
-                val floatArray = FloatArray(floatBuffer.remaining())
+    // Returns the path of the preferences file, which only exists if the app ships one
+    private fun copyPreferencesFromAssetsToInternalStorage(): String {
+        val preferencesFile = File(context.filesDir, PREFERENCES_FILE)
 
-                floatBuffer.get(floatArray)
-                floatArray
-            }
-
-            else -> {
-                throw IllegalArgumentException("Unsupported output data type: ${dataType}")
-            }
+        if (context.assets.list("")?.contains(PREFERENCES_FILE) == true) {
+            copyNNCFromAssetsToInternalStorage(PREFERENCES_FILE)
+        } else {
+            preferencesFile.delete()
         }
+        return preferencesFile.absolutePath
     }
 
     private fun copyNNCFromAssetsToInternalStorage(filename: String) {
@@ -350,10 +291,6 @@ class ModelExecutor(
         }
     }
 
-    private fun sigmoid(x: Float): Float {
-        return (1.0f / (1.0f + exp(-x)))
-    }
-
     interface ExecutorListener {
         fun onError(error: String)
         fun onResults(
@@ -369,7 +306,6 @@ class ModelExecutor(
 
         private const val INPUT_SIZE_W = ModelConstants.INPUT_SIZE_W
         private const val INPUT_SIZE_H = ModelConstants.INPUT_SIZE_H
-        private const val INPUT_SIZE_C = ModelConstants.INPUT_SIZE_C
 
         private const val INPUT_CONVERSION_SCALE = ModelConstants.INPUT_CONVERSION_SCALE
         private const val INPUT_CONVERSION_OFFSET = ModelConstants.INPUT_CONVERSION_OFFSET
@@ -382,8 +318,10 @@ class ModelExecutor(
 
         private val OFFSET_DATA_TYPE = ModelConstants.OFFSET_DATA_TYPE
 
-        private const val OFFSET_SIZE_C = ModelConstants.OFFSET_SIZE_C
-        private const val OFFSET_SIZE_H = ModelConstants.OFFSET_SIZE_H
-        private const val OFFSET_SIZE_W = ModelConstants.OFFSET_SIZE_W
+        // Written by enn_nnc_model_tester --sweep-preferences
+        private const val PREFERENCES_FILE = "enn_preferences.cfg"
+
+        // Number of sessions kept in flight by processStream()
+        private const val BUFFER_RING_DEPTH = 2
     }
 }
@@ -17,12 +17,8 @@ class OverlayView(
     private var scaleWidth: Int = 0
     private var scaleHeight: Int = 0
 
-    fun setResults(pixels: IntArray, imageWidth: Int, imageHeight: Int) {
-        val image = Bitmap.createBitmap(
-            pixels, imageWidth, imageHeight, Bitmap.Config.ARGB_8888
-        )
-
-        resultMask = createScaledBitmap(image, imageWidth, imageHeight)
+    fun setResults(mask: Bitmap) {
+        resultMask = createScaledBitmap(mask, mask.width, mask.height)
     }
 
     private fun createScaledBitmap(image: Bitmap, imageWidth: Int, imageHeight: Int): Bitmap {
@@ -109,11 +109,11 @@ class ImageFragment : Fragment(), ModelExecutor.ExecutorListener {
     }
 
     override fun onResults(
-        result: IntArray, inferenceTime: Long
+        result: Bitmap, inferenceTime: Long
     ) {
         activity?.runOnUiThread {
             binding.processData.inferenceTime.text = "$inferenceTime ms"
-            binding.overlay.setResults(result, OUTPUT_SIZE_W, OUTPUT_SIZE_H)
+            binding.overlay.setResults(result)
             binding.overlay.invalidate()
         }
     }
@@ -127,7 +127,5 @@ class ImageFragment : Fragment(), ModelExecutor.ExecutorListener {
         private const val TAG = "ImageFragment"
         private const val INPUT_SIZE_W = ModelConstants.INPUT_SIZE_W
         private const val INPUT_SIZE_H = ModelConstants.INPUT_SIZE_H
-        private const val OUTPUT_SIZE_W = ModelConstants.OUTPUT_SIZE_W
-        private const val OUTPUT_SIZE_H = ModelConstants.OUTPUT_SIZE_H
     }
 }
\ No newline at end of file